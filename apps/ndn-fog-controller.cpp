@@ -0,0 +1,512 @@
+// ndn-fog-controller.cpp — Fog Node Controller application
+
+#include "ndn-fog-controller.hpp"
+
+#include "NFD/daemon/fw/access-report.hpp"
+#include "NFD/daemon/fw/fog-tlv.hpp"
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/node-list.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include "model/ndn-l3-protocol.hpp"
+#include "helper/ndn-fib-helper.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+NS_LOG_COMPONENT_DEFINE("ndn.FogController");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(FogController);
+
+namespace {
+
+const Name FOG_PREFIX("/fog");
+const Name REPORT_PREFIX("/fog/access-report");
+const Name INSTRUCTION_PREFIX("/fog/instruction");
+
+constexpr size_t INITIAL_INDEX_SIZE = 1024;
+
+// seg=<n> sizes a per-node bitmap; the widest sketch report in the smallest
+// report-segment (4 × 2^20 counters of ≤ 5 bytes in 256 B) needs ~90 000
+constexpr uint64_t MAX_REPORT_SEGMENTS = uint64_t(1) << 17;
+
+// α = 1 (no memory) is run as 1 − 10⁻⁶ so the key scale stays finite
+constexpr double MIN_DECAY     = 1e-6;
+// keys are rebased once the scale reaches this, far below DBL_MAX
+constexpr double RESCALE_LIMIT = 1e200;
+
+} // unnamed namespace
+
+TypeId
+FogController::GetTypeId()
+{
+  static TypeId tid =
+    TypeId("ns3::ndn::FogController")
+      .SetGroupName("Ndn")
+      .SetParent<App>()
+      .AddConstructor<FogController>()
+      .AddAttribute("Interval", "Prediction period τ", TimeValue(Seconds(30)),
+                    MakeTimeAccessor(&FogController::m_interval), MakeTimeChecker())
+      .AddAttribute("TopK", "Number of contents instructed with ThetaHigh", UintegerValue(100),
+                    MakeUintegerAccessor(&FogController::m_topKSize),
+                    MakeUintegerChecker<uint32_t>(1))
+      .AddAttribute("Alpha", "Moving-average weight of the newest period", DoubleValue(0.5),
+                    MakeDoubleAccessor(&FogController::m_alpha),
+                    MakeDoubleChecker<double>(0.0, 1.0))
+      .AddAttribute("ThetaHigh", "Cache probability of predicted popular contents",
+                    DoubleValue(0.9), MakeDoubleAccessor(&FogController::m_thetaHigh),
+                    MakeDoubleChecker<double>(0.0, 1.0))
+      .AddAttribute("ThetaLow", "Cache probability of everything else", DoubleValue(0.1),
+                    MakeDoubleAccessor(&FogController::m_thetaLow),
+                    MakeDoubleChecker<double>(0.0, 1.0))
+      .AddAttribute("FullEvery", "Send full instead of delta instructions every n epochs",
+                    UintegerValue(10), MakeUintegerAccessor(&FogController::m_fullEvery),
+                    MakeUintegerChecker<uint32_t>(1))
+
+      .AddTraceSource("Prediction", "Epoch, known contents and instructions sent per period",
+                      MakeTraceSourceAccessor(&FogController::m_predictionTrace),
+                      "ns3::ndn::FogController::PredictionTraceCallback");
+  return tid;
+}
+
+FogController::FogController()
+  : m_index(INITIAL_INDEX_SIZE)
+{
+  NS_LOG_FUNCTION_NOARGS();
+}
+
+void
+FogController::StartApplication()
+{
+  NS_LOG_FUNCTION_NOARGS();
+  App::StartApplication();
+
+  FibHelper::AddRoute(GetNode(), FOG_PREFIX, m_face, 0);
+  m_predictionEvent = Simulator::Schedule(m_interval, &FogController::PeriodicPrediction, this);
+}
+
+void
+FogController::StopApplication()
+{
+  NS_LOG_FUNCTION_NOARGS();
+  Simulator::Cancel(m_predictionEvent);
+
+  App::StopApplication();
+}
+
+// ────────────────────────────────────────────────────────────────
+// OnReceive / HandleAccessReport
+void
+FogController::OnData(shared_ptr<const Data> data)
+{
+  if (!m_active)
+    return;
+
+  App::OnData(data); // tracing inside
+
+  const Name& name = data->getName();
+  if (!REPORT_PREFIX.isPrefixOf(name))
+    return;
+
+  // /fog/access-report/<nodeId>/v=<t>/seg=<n>
+  uint32_t nodeId;
+  uint64_t version;
+  uint64_t segment;
+  try {
+    nodeId  = static_cast<uint32_t>(name.at(2).toNumber());
+    version = name.at(3).toVersion();
+    segment = name.at(4).toSegment();
+    if (segment >= MAX_REPORT_SEGMENTS)
+      throw std::out_of_range("segment " + std::to_string(segment) + " beyond the report limit");
+  }
+  catch (const std::exception& e) {
+    NS_LOG_DEBUG("Malformed report name " << name << " (" << e.what() << ")");
+    return;
+  }
+
+  if (nodeId >= NodeList::GetNNodes()) {
+    NS_LOG_DEBUG("Report from unknown node " << nodeId);
+    return;
+  }
+
+  // reports may arrive over several neighbours: count each segment once
+  if (nodeId >= m_nodes.size())
+    m_nodes.resize(nodeId + 1);
+  NodeState& node = m_nodes[nodeId];
+  if (version < node.reportVersion)
+    return;
+  if (version > node.reportVersion) {
+    node.reportVersion = version;
+    node.segments.clear();
+  }
+  if (segment >= node.segments.size())
+    node.segments.resize(segment + 1);
+  if (node.segments[segment])
+    return;
+  node.segments[segment] = true;
+
+  if (!node.reported) {
+    node.reported = true;
+    m_reporters.push_back(nodeId);
+  }
+
+  try {
+    HandleAccessReport(nodeId, data->getContent().blockFromValue());
+  }
+  catch (const std::exception& e) {
+    NS_LOG_DEBUG("Malformed report " << name << " (" << e.what() << ")");
+  }
+}
+
+void
+FogController::HandleAccessReport(uint32_t nodeId, const Block& segment)
+{
+  if (segment.type() == TLV_SKETCH) {
+    // the first segment of τ sizes the merged sketch, the rest add in place
+    if (!m_windowSketch)
+      m_windowSketch = std::make_unique<CountMinSketch>(CountMinSketch::wireDecode(segment));
+    else
+      m_windowSketch->mergeWire(segment);   // throws on a shape mismatch
+    return;
+  }
+
+  decodeAccessReport(segment, [this, nodeId] (const Name& name, uint64_t count) {
+    if (count == 0)
+      return;
+    const ContentId id = Intern(name);
+    if (m_firstEpoch[id] == 0)
+      m_firstEpoch[id] = m_epoch;
+    if (m_windowCount[id] == 0)
+      m_touched.push_back(id);
+    m_globalAccessLog[id] += count;
+    m_windowCount[id]     += count;
+    m_nodeAccess.push_back({nodeId, id, count});
+    AddAccesses(id, count);
+  });
+}
+
+// ────────────────────────────────────────────────────────────────
+// content interning
+FogController::ContentId
+FogController::Intern(const Name& name)
+{
+  const NameDigest digest = computeNameDigest(name);
+  if ((m_names.size() + 1) * 2 > m_index.size())
+    GrowIndex();
+
+  const size_t mask = m_index.size() - 1;
+  for (size_t i = digest & mask;; i = (i + 1) & mask) {
+    IndexSlot& slot = m_index[i];
+    if (slot.id == NO_CONTENT) {
+      slot.digest = digest;
+      slot.id     = static_cast<ContentId>(m_names.size());
+      m_names.push_back(name);
+      m_digests.push_back(digest);
+      m_globalAccessLog.push_back(0);
+      m_windowCount.push_back(0);
+      m_forecastKey.push_back(0.0);
+      m_firstEpoch.push_back(0);
+      m_heapPos.push_back(NOT_TOP);
+      return slot.id;
+    }
+    if (slot.digest == digest)          // 64-bit digests: collisions ignored
+      return slot.id;
+  }
+}
+
+void
+FogController::GrowIndex()
+{
+  std::vector<IndexSlot> index(m_index.size() * 2);
+  const size_t mask = index.size() - 1;
+  for (const IndexSlot& slot : m_index) {
+    if (slot.id == NO_CONTENT)
+      continue;
+    size_t i = slot.digest & mask;
+    while (index[i].id != NO_CONTENT)
+      i = (i + 1) & mask;
+    index[i] = slot;
+  }
+  m_index.swap(index);
+}
+
+// ────────────────────────────────────────────────────────────────
+// PeriodicPrediction
+void
+FogController::PeriodicPrediction()
+{
+  ApplySketchCounts();
+  const size_t nSent = PushCacheInstructions();
+
+  NS_LOG_INFO("epoch=" << m_epoch << " contents=" << m_names.size() << " top=" << m_topK.size()
+              << " reporters=" << m_reporters.size() << " instructions=" << nSent);
+  m_predictionTrace(m_epoch, static_cast<uint32_t>(m_names.size()), static_cast<uint32_t>(nSent));
+
+  // reset the per-period state (ICN_Map, window counts)
+  for (ContentId id : m_touched)
+    m_windowCount[id] = 0;
+  m_touched.clear();
+  m_nodeAccess.clear();
+  m_windowSketch.reset();
+  for (uint32_t nodeId : m_reporters)
+    m_nodes[nodeId].reported = false;
+  m_reporters.clear();
+
+  ++m_epoch;
+  AdvanceScale();
+
+  m_predictionEvent = Simulator::Schedule(m_interval, &FogController::PeriodicPrediction, this);
+}
+
+// ────────────────────────────────────────────────────────────────
+// ForecastScore / SelectTopK, maintained per access
+//
+// ForecastScore is kept as key = score · scale, scale = (1 − α)^−epoch
+// (rebased now and then).  The per-period decay of every score is then a
+// single scale update, and an access adds weight · count · scale to one key;
+// keys only grow, so the top-K is a min-heap whose root is the bar a
+// content has to clear, and no content outside it ever needs ordering.
+void
+FogController::AddAccesses(ContentId id, uint64_t count)
+{
+  // MovingAverage: in the first period, prev defaults to count
+  const double weight = m_firstEpoch[id] == m_epoch ? 1.0 : m_alpha;
+  m_forecastKey[id] += weight * static_cast<double>(count) * m_scale;
+
+  if (m_heapPos[id] != NOT_TOP) {
+    HeapDown(m_heapPos[id]);
+    return;
+  }
+  if (m_topK.size() < m_topKSize) {
+    m_topK.push_back(id);
+    HeapUp(m_topK.size() - 1);
+    return;
+  }
+  const ContentId min = m_topK.front();
+  if (m_forecastKey[id] <= m_forecastKey[min])
+    return;
+  m_heapPos[min] = NOT_TOP;
+  HeapPlace(0, id);
+  HeapDown(0);
+}
+
+void
+FogController::ApplySketchCounts()
+{
+  if (!m_windowSketch)
+    return;
+
+  // the sketch saw every access of the period, the names only each node's
+  // top; looked up for the contents named this period and the current
+  // top-K, which are the ones whose rank it can change
+  m_sketchIds.assign(m_touched.begin(), m_touched.end());
+  m_sketchIds.insert(m_sketchIds.end(), m_topK.begin(), m_topK.end());
+  for (ContentId id : m_sketchIds) {
+    const uint64_t est = m_windowSketch->estimate(m_digests[id]);
+    if (est <= m_windowCount[id])
+      continue;
+    if (m_windowCount[id] == 0)
+      m_touched.push_back(id);
+    AddAccesses(id, est - m_windowCount[id]);
+    m_windowCount[id] = est;
+  }
+}
+
+void
+FogController::AdvanceScale()
+{
+  m_scale /= std::max(1.0 - m_alpha, MIN_DECAY);
+  if (m_scale < RESCALE_LIMIT)
+    return;
+
+  // every log(RESCALE_LIMIT) / log(1 / (1 − α)) periods (≈ 660 for α = 0.5);
+  // a common factor keeps the heap order
+  for (double& key : m_forecastKey)
+    key /= m_scale;
+  m_scale = 1.0;
+}
+
+void
+FogController::HeapPlace(size_t pos, ContentId id)
+{
+  m_topK[pos] = id;
+  m_heapPos[id] = static_cast<uint32_t>(pos);
+}
+
+void
+FogController::HeapUp(size_t pos)
+{
+  const ContentId id = m_topK[pos];
+  const double key = m_forecastKey[id];
+  while (pos > 0) {
+    size_t parent = (pos - 1) / 2;
+    if (m_forecastKey[m_topK[parent]] <= key)
+      break;
+    HeapPlace(pos, m_topK[parent]);
+    pos = parent;
+  }
+  HeapPlace(pos, id);
+}
+
+void
+FogController::HeapDown(size_t pos)
+{
+  const ContentId id = m_topK[pos];
+  const double key = m_forecastKey[id];
+  const size_t n = m_topK.size();
+  for (;;) {
+    size_t child = 2 * pos + 1;
+    if (child >= n)
+      break;
+    if (child + 1 < n && m_forecastKey[m_topK[child + 1]] < m_forecastKey[m_topK[child]])
+      ++child;
+    if (key <= m_forecastKey[m_topK[child]])
+      break;
+    HeapPlace(pos, m_topK[child]);
+    pos = child;
+  }
+  HeapPlace(pos, id);
+}
+
+size_t
+FogController::PushCacheInstructions()
+{
+  // ICN_Map ∩ TopKList, per node
+  for (const Access& access : m_nodeAccess) {
+    if (m_heapPos[access.content] != NOT_TOP)
+      m_nodes[access.node].pending.push_back(access.content);
+  }
+
+  std::vector<ContentId> added;
+  std::vector<ContentId> withdrawn;
+  size_t nSent = 0;
+  for (uint32_t nodeId : m_reporters) {
+    NodeState& node = m_nodes[nodeId];
+    std::sort(node.pending.begin(), node.pending.end());
+    node.pending.erase(std::unique(node.pending.begin(), node.pending.end()), node.pending.end());
+
+    // counted per node: one that skipped the epoch its full was due gets it next time
+    const bool full = node.lastFull == 0 || m_epoch - node.lastFull >= m_fullEvery;
+    if (full) {
+      SendInstruction(nodeId, node.pending, {}, true);
+    }
+    else {
+      added.clear();
+      withdrawn.clear();
+      std::set_difference(node.pending.begin(), node.pending.end(), node.high.begin(), node.high.end(),
+                          std::back_inserter(added));
+      std::set_difference(node.high.begin(), node.high.end(), node.pending.begin(), node.pending.end(),
+                          std::back_inserter(withdrawn));
+      if (added.empty() && withdrawn.empty()) {
+        node.pending.clear();
+        continue;                          // nothing changed, the node's epoch stays valid
+      }
+      SendInstruction(nodeId, added, withdrawn, false);
+    }
+
+    node.high.swap(node.pending);
+    node.pending.clear();
+    node.epoch = m_epoch;
+    if (full) {
+      node.lastFull = m_epoch;
+      m_fullDue.push_back({m_epoch + m_fullEvery, nodeId});
+    }
+    ++nSent;
+  }
+
+  // known nodes that went quiet: refresh θ before it expires, keeping only
+  // the ThetaHigh contents still in the TopKList; entries a later full
+  // instruction superseded are skipped
+  while (!m_fullDue.empty() && m_fullDue.front().epoch <= m_epoch) {
+    const uint32_t nodeId = m_fullDue.front().node;
+    const bool stale = m_fullDue.front().epoch != m_nodes[nodeId].lastFull + m_fullEvery;
+    m_fullDue.pop_front();
+    if (stale)
+      continue;
+
+    NodeState& node = m_nodes[nodeId];
+    node.high.erase(std::remove_if(node.high.begin(), node.high.end(),
+                                   [this] (ContentId id) { return m_heapPos[id] == NOT_TOP; }),
+                    node.high.end());
+    SendInstruction(nodeId, node.high, {}, true);
+    node.epoch = node.lastFull = m_epoch;
+    m_fullDue.push_back({m_epoch + m_fullEvery, nodeId});
+    ++nSent;
+  }
+  return nSent;
+}
+
+// ────────────────────────────────────────────────────────────────
+// PushCacheInstruction
+void
+FogController::SendInstruction(uint32_t nodeId, const std::vector<ContentId>& high,
+                               const std::vector<ContentId>& withdrawn, bool full)
+{
+  using ::ndn::encoding::prependNonNegativeIntegerBlock;
+
+  auto thetaValue = [] (double theta) { return static_cast<uint64_t>(std::lround(theta * 10000)); };
+  const uint64_t ttl = static_cast<uint64_t>(std::ceil(m_interval.GetSeconds() * (m_fullEvery + 1)));
+
+  // ThetaVector = EPOCH [BASE] TTL *PAIR, prepended back to front
+  ::ndn::EncodingBuffer enc;
+  size_t len = 0;
+  auto prependPair = [&] (const Name& name, const uint64_t* theta) {
+    size_t l = 0;
+    if (theta != nullptr)
+      l += prependNonNegativeIntegerBlock(enc, ::ndn::tlv::NonNegativeInteger, *theta);
+    l += name.wireEncode(enc);
+    l += enc.prependVarNumber(l);
+    l += enc.prependVarNumber(TLV_THETA_PAIR);
+    len += l;
+  };
+
+  const uint64_t thetaHigh = thetaValue(m_thetaHigh);
+  for (auto it = withdrawn.rbegin(); it != withdrawn.rend(); ++it)
+    prependPair(m_names[*it], nullptr);
+  for (auto it = high.rbegin(); it != high.rend(); ++it)
+    prependPair(m_names[*it], &thetaHigh);
+  if (full) {
+    const uint64_t low = thetaValue(m_thetaLow);
+    prependPair(Name(), &low);                // "/" : everything not listed
+  }
+
+  len += prependNonNegativeIntegerBlock(enc, TLV_THETA_TTL, ttl);
+  if (!full)
+    len += prependNonNegativeIntegerBlock(enc, TLV_THETA_BASE, m_nodes[nodeId].epoch);
+  len += prependNonNegativeIntegerBlock(enc, TLV_THETA_EPOCH, m_epoch);
+  len += enc.prependVarNumber(len);
+  len += enc.prependVarNumber(TLV_THETA_VECTOR);
+
+  auto data = make_shared<Data>(Name(INSTRUCTION_PREFIX).appendNumber(nodeId).appendVersion(m_epoch));
+  data->setContent(enc.block());
+  data->setFreshnessPeriod(::ndn::time::seconds(1));
+
+  // same placeholder signature as Producer: instructions are not verified
+  ::ndn::Signature signature;
+  ::ndn::SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
+  signature.setInfo(signatureInfo);
+  signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, 0));
+  data->setSignature(signature);
+  data->wireEncode();
+
+  NS_LOG_DEBUG("instruction node=" << nodeId << (full ? " full" : " delta") << " epoch=" << m_epoch
+               << " high=" << high.size() << " withdrawn=" << withdrawn.size());
+
+  m_transmittedDatas(data, this, m_face);
+  m_appLink->onReceiveData(*data);
+}
+
+} // namespace ndn
+} // namespace ns3
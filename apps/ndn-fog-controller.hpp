@@ -0,0 +1,198 @@
+// ndn-fog-controller.hpp
+// ===========================
+#ifndef NDN_FOG_CONTROLLER_H
+#define NDN_FOG_CONTROLLER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ndn-app.hpp"
+#include "NFD/daemon/fw/cms.hpp"
+#include "NFD/daemon/fw/name-digest.hpp"
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * @brief Fog Node Controller (Fog-Node-Controller-Algorithm.txt)
+ *
+ * Consumes the /fog/access-report/<nodeId>/v=<t>/seg=<n> reports that
+ * CustomStrategy relays up the FIB, and every Interval (τ):
+ *
+ *  ─ ForecastScore ← α · count + (1 − α) · ForecastScore for every content,
+ *    count being this τ's accesses (the sum of the reported counts, raised to
+ *    the merged report sketches' estimate when nodes send
+ *    report-format~sketch);
+ *  ─ TopKList ← the TopK highest scores;
+ *  ─ sends every node that reported in τ a ThetaVector (fog-tlv.hpp) as
+ *    /fog/instruction/<nodeId>/v=<epoch>: ThetaHigh for the TopKList contents
+ *    that node reported (ICN_Map), ThetaLow on "/" for everything else;
+ *  ─ sends every known node that did not report since its last full
+ *    instruction, FullEvery epochs ago, a full one refreshing its θ: its
+ *    ThetaHigh contents still in the TopKList, ThetaLow on "/".
+ *
+ * Content names are interned once into dense ContentIds through an
+ * open-addressed digest index; GlobalAccessLog, ForecastScore and the per-τ
+ * counts are vectors indexed by ContentId, and NodeAccessMap / ICN_Map are a
+ * single flat list of (node, content, count) for the τ.  ForecastScore and
+ * TopKList are updated as each report entry arrives (scaled keys, indexed
+ * min-heap of the TopK), so the period boundary costs O(report entries + k),
+ * independent of both the number of nodes and the catalogue size.
+ *
+ * An instruction is a delta (new ThetaHigh contents, withdrawals) on the
+ * epoch last sent to that node, and a full one on the first contact and
+ * once FullEvery epochs have passed since that node's last full one, whether
+ * or not it reported since; every entry lives (FullEvery + 1) · τ, so θ fades
+ * only at a node the controller stops reaching.  Due refreshes sit in a FIFO
+ * by epoch, so the period boundary still never walks all nodes.
+ *
+ * Nodes should run CustomStrategy with report-target~fib, and /fog must be
+ * routed to the controller's node (e.g. GlobalRoutingHelper::AddOrigins).
+ */
+class FogController : public App
+{
+public:
+  static TypeId
+  GetTypeId();
+
+  FogController();
+
+  virtual void
+  OnData(shared_ptr<const Data> data);
+
+  using ContentId = uint32_t;
+
+  typedef void (*PredictionTraceCallback)(uint64_t epoch, uint32_t contents, uint32_t instructions);
+
+protected:
+  // inherited from Application base class.
+  virtual void
+  StartApplication();
+
+  virtual void
+  StopApplication();
+
+private:
+  void
+  HandleAccessReport(uint32_t nodeId, const Block& segment);
+
+  void
+  PeriodicPrediction();
+
+  void
+  AddAccesses(ContentId id, uint64_t count);
+
+  void
+  ApplySketchCounts();
+
+  void
+  AdvanceScale();
+
+  void
+  HeapPlace(size_t pos, ContentId id);
+
+  void
+  HeapUp(size_t pos);
+
+  void
+  HeapDown(size_t pos);
+
+  /// @return the number of instructions sent
+  size_t
+  PushCacheInstructions();
+
+  void
+  SendInstruction(uint32_t nodeId, const std::vector<ContentId>& high,
+                  const std::vector<ContentId>& withdrawn, bool full);
+
+  ContentId
+  Intern(const Name& name);
+
+  void
+  GrowIndex();
+
+private:
+  static constexpr ContentId NO_CONTENT = std::numeric_limits<ContentId>::max();
+  static constexpr uint32_t  NOT_TOP    = std::numeric_limits<uint32_t>::max();
+
+  // ── interned contents ──────────────────────────────────────
+  struct IndexSlot
+  {
+    NameDigest digest = 0;
+    ContentId  id     = NO_CONTENT;
+  };
+  std::vector<IndexSlot> m_index;            ///< linear probing, power-of-two size
+  std::vector<Name>      m_names;            ///< ContentId → Name
+  std::vector<NameDigest> m_digests;         ///< ContentId → digest (sketch queries)
+
+  // ── per-content state, indexed by ContentId ───────────────
+  std::vector<uint64_t>  m_globalAccessLog;  ///< running total
+  std::vector<uint64_t>  m_windowCount;      ///< reported in this τ
+  std::vector<ContentId> m_touched;          ///< contents with m_windowCount > 0
+  std::vector<double>    m_forecastKey;      ///< ForecastScore × m_scale
+  std::vector<uint64_t>  m_firstEpoch;       ///< epoch of the first access
+  std::vector<uint32_t>  m_heapPos;          ///< index in m_topK, NOT_TOP if outside
+  std::vector<ContentId> m_topK;             ///< TopKList: min-heap on m_forecastKey
+  double                 m_scale = 1.0;      ///< (1 − α)^−epoch, rebased
+  std::unique_ptr<CountMinSketch> m_windowSketch;   ///< merged report sketches of τ
+  std::vector<ContentId> m_sketchIds;        ///< scratch for ApplySketchCounts
+
+  // ── NodeAccessMap / ICN_Map of this τ ─────────────────────
+  struct Access
+  {
+    uint32_t  node;
+    ContentId content;
+    uint64_t  count;
+  };
+  std::vector<Access>    m_nodeAccess;
+
+  // ── per-node state, indexed by ns-3 node id ───────────────
+  struct NodeState
+  {
+    uint64_t               reportVersion = 0;
+    std::vector<bool>      segments;        ///< seen segments of reportVersion
+    bool                   reported = false;   ///< in this τ
+    uint64_t               epoch = 0;       ///< last instruction sent, 0: none
+    uint64_t               lastFull = 0;    ///< last full instruction sent, 0: none
+    std::vector<ContentId> high;            ///< ThetaHigh contents as of epoch, sorted
+    std::vector<ContentId> pending;         ///< ThetaHigh contents for this τ
+  };
+  std::vector<NodeState> m_nodes;
+  std::vector<uint32_t>  m_reporters;       ///< nodes that reported in this τ
+
+  struct FullDue
+  {
+    uint64_t epoch;                         ///< lastFull + FullEvery
+    uint32_t node;
+  };
+  std::deque<FullDue>    m_fullDue;         ///< one per full instruction, in epoch order
+
+  uint64_t m_epoch = 1;                     ///< collecting period = its instructions' epoch
+  EventId  m_predictionEvent;
+
+  // attributes
+  Time     m_interval;
+  uint32_t m_topKSize;
+  double   m_alpha;
+  double   m_thetaHigh;
+  double   m_thetaLow;
+  uint32_t m_fullEvery;
+
+  /// epoch, number of known contents, number of instructions sent
+  TracedCallback<uint64_t, uint32_t, uint32_t> m_predictionTrace;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_FOG_CONTROLLER_H
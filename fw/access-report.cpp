@@ -0,0 +1,320 @@
+// access-report.cpp — prefix-dictionary / varint access-report codec
+
+#include "access-report.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+#include <ndn-cxx/encoding/tlv.hpp>
+
+#include <algorithm>
+#include <map>
+#include <string>
+
+namespace {
+
+using ndn::name::Component;
+
+// room left in every segment for the AccessReport header and AccessOther
+constexpr size_t SEGMENT_RESERVE = 16;
+
+void
+appendLeb128(std::vector<uint8_t>& out, uint64_t v)
+{
+  while (v >= 0x80) {
+    out.push_back(static_cast<uint8_t>(v) | 0x80);
+    v >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(v));
+}
+
+size_t
+leb128Size(uint64_t v)
+{
+  size_t n = 1;
+  for (; v >= 0x80; v >>= 7)
+    ++n;
+  return n;
+}
+
+uint64_t
+readLeb128(const uint8_t*& p, const uint8_t* end)
+{
+  uint64_t v = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    if (p == end)
+      NDN_THROW(ndn::tlv::Error("Truncated LEB128 in AccessSeqRun"));
+    uint8_t b = *p++;
+    v |= static_cast<uint64_t>(b & 0x7F) << shift;
+    if ((b & 0x80) == 0)
+      return v;
+  }
+  NDN_THROW(ndn::tlv::Error("Oversized LEB128 in AccessSeqRun"));
+}
+
+size_t
+tlvSize(uint32_t type, size_t valueLength)
+{
+  return ndn::tlv::sizeOfVarNumber(type) + ndn::tlv::sizeOfVarNumber(valueLength) + valueLength;
+}
+
+/** true if @p comp is a sequence-number component that re-encodes
+    byte-for-byte, so the decoder can rebuild it from the number alone */
+bool
+isCompressibleSeq(const Component& comp)
+{
+  return comp.isSequenceNumber() &&
+         Component::fromSequenceNumber(comp.toSequenceNumber()) == comp;
+}
+
+/** Fills AccessReport blocks up to a byte budget, one AccessPrefix
+    "chunk" at a time; a chunk that would overflow is closed and reopened
+    (same prefix) in the next segment. */
+class Packer
+{
+public:
+  explicit
+  Packer(size_t maxBytes)
+    : m_budget(maxBytes > SEGMENT_RESERVE ? maxBytes - SEGMENT_RESERVE : 1)
+  {
+  }
+
+  void
+  beginPrefix(const ndn::Name& prefix)
+  {
+    m_prefix     = prefix;
+    m_prefixWire = prefix.wireEncode().size();
+    resetChunk();
+  }
+
+  void
+  addSeq(uint64_t seq, uint64_t count)
+  {
+    // measured on the chunk it would join; after makeRoom() the entry opens
+    // an empty segment with deltas from 0, the largest piece is then seq itself
+    if (!fits(m_run.size() + seqPieceSize(seq, count), m_suffixBytes))
+      makeRoom();
+    appendLeb128(m_run, seq - m_prevSeq);
+    appendLeb128(m_run, count);
+    m_prevSeq = seq;
+  }
+
+  void
+  addSuffix(const Component& comp, uint64_t count)
+  {
+    ndn::Block countBlock = ndn::makeNonNegativeIntegerBlock(ndn::tlv::NonNegativeInteger, count);
+    const size_t piece = tlvSize(TLV_ACCESS_SUFFIX, comp.size() + countBlock.size());
+    if (!fits(m_run.size(), m_suffixBytes + piece))
+      makeRoom();
+    m_suffixes.emplace_back(comp, count);
+    m_suffixBytes += piece;
+  }
+
+  void
+  endPrefix()
+  {
+    flushChunk();
+  }
+
+  std::vector<ndn::Block>
+  finish(uint64_t other)
+  {
+    flushSegment(other);
+    return std::move(m_segments);
+  }
+
+private:
+  size_t
+  chunkSize(size_t runBytes, size_t suffixBytes) const
+  {
+    size_t value = m_prefixWire + suffixBytes;
+    if (runBytes > 0)
+      value += tlvSize(TLV_ACCESS_SEQ_RUN, runBytes);
+    return tlvSize(TLV_ACCESS_PREFIX, value);
+  }
+
+  /// bytes (seq, count) adds to the SeqRun, delta-coded on m_prevSeq
+  size_t
+  seqPieceSize(uint64_t seq, uint64_t count) const
+  {
+    return leb128Size(seq - m_prevSeq) + leb128Size(count);
+  }
+
+  bool
+  fits(size_t runBytes, size_t suffixBytes) const
+  {
+    return m_segmentBytes + chunkSize(runBytes, suffixBytes) <= m_budget;
+  }
+
+  bool
+  chunkEmpty() const
+  {
+    return m_run.empty() && m_suffixes.empty();
+  }
+
+  /// close the current segment (and chunk) so the next entry starts afresh;
+  /// an entry that cannot fit even an empty segment is emitted anyway
+  void
+  makeRoom()
+  {
+    if (chunkEmpty() && m_chunks.empty())
+      return;
+    flushChunk();
+    flushSegment(0);
+  }
+
+  void
+  resetChunk()
+  {
+    m_run.clear();
+    m_suffixes.clear();
+    m_suffixBytes = 0;
+    m_prevSeq     = 0;
+  }
+
+  void
+  flushChunk()
+  {
+    if (chunkEmpty())
+      return;
+
+    ndn::EncodingBuffer enc;
+    size_t len = 0;
+    for (auto it = m_suffixes.rbegin(); it != m_suffixes.rend(); ++it) {
+      size_t l = ndn::encoding::prependNonNegativeIntegerBlock(enc, ndn::tlv::NonNegativeInteger, it->second);
+      l += it->first.wireEncode(enc);
+      l += enc.prependVarNumber(l);
+      l += enc.prependVarNumber(TLV_ACCESS_SUFFIX);
+      len += l;
+    }
+    if (!m_run.empty())
+      len += ndn::encoding::prependByteArrayBlock(enc, TLV_ACCESS_SEQ_RUN, m_run.data(), m_run.size());
+    len += m_prefix.wireEncode(enc);
+    len += enc.prependVarNumber(len);
+    len += enc.prependVarNumber(TLV_ACCESS_PREFIX);
+
+    m_segmentBytes += len;
+    m_chunks.push_back(enc.block());
+    resetChunk();
+  }
+
+  void
+  flushSegment(uint64_t other)
+  {
+    if (m_chunks.empty() && other == 0 && !m_segments.empty())
+      return;
+
+    ndn::EncodingBuffer enc;
+    size_t len = 0;
+    if (other > 0)
+      len += ndn::encoding::prependNonNegativeIntegerBlock(enc, TLV_ACCESS_OTHER, other);
+    for (auto it = m_chunks.rbegin(); it != m_chunks.rend(); ++it)
+      len += enc.prependBlock(*it);
+    len += enc.prependVarNumber(len);
+    len += enc.prependVarNumber(TLV_ACCESS_REPORT);
+
+    m_segments.push_back(enc.block());
+    m_chunks.clear();
+    m_segmentBytes = 0;
+  }
+
+private:
+  const size_t m_budget;
+
+  std::vector<ndn::Block> m_segments;
+  std::vector<ndn::Block> m_chunks;              ///< AccessPrefix blocks of the open segment
+  size_t                  m_segmentBytes = 0;
+
+  ndn::Name               m_prefix;
+  size_t                  m_prefixWire = 0;
+  std::vector<uint8_t>    m_run;                 ///< AccessSeqRun value
+  uint64_t                m_prevSeq = 0;
+  std::vector<std::pair<Component, uint64_t>> m_suffixes;
+  size_t                  m_suffixBytes = 0;
+};
+
+struct Group
+{
+  std::vector<std::pair<uint64_t, uint64_t>>  seqs;       ///< (seq, count)
+  std::vector<std::pair<Component, uint64_t>> suffixes;   ///< (last component, count)
+};
+
+} // unnamed namespace
+
+std::vector<ndn::Block>
+encodeAccessReport(const std::vector<SpaceSaving::Item>& items, uint64_t other, size_t maxBytes)
+{
+  // shared-prefix dictionary, ordered so siblings end up adjacent
+  std::map<ndn::Name, Group> groups;
+  for (const auto& item : items) {
+    const ndn::Name& name = *item.name;
+    if (name.empty()) {
+      other += item.count;
+      continue;
+    }
+    Group& g = groups[name.getPrefix(-1)];
+    const Component& last = name.get(-1);
+    if (isCompressibleSeq(last))
+      g.seqs.emplace_back(last.toSequenceNumber(), item.count);
+    else
+      g.suffixes.emplace_back(last, item.count);
+  }
+
+  Packer packer(maxBytes);
+  for (auto& [prefix, g] : groups) {
+    std::sort(g.seqs.begin(), g.seqs.end());
+    packer.beginPrefix(prefix);
+    for (const auto& [seq, count] : g.seqs)
+      packer.addSeq(seq, count);
+    for (const auto& [comp, count] : g.suffixes)
+      packer.addSuffix(comp, count);
+    packer.endPrefix();
+  }
+  return packer.finish(other);
+}
+
+uint64_t
+decodeAccessReport(const ndn::Block& report,
+                   const std::function<void(const ndn::Name&, uint64_t)>& onEntry)
+{
+  if (report.type() != TLV_ACCESS_REPORT)
+    NDN_THROW(ndn::tlv::Error("Expecting AccessReport, got TLV-TYPE " + std::to_string(report.type())));
+
+  uint64_t other = 0;
+  report.parse();
+  for (const ndn::Block& element : report.elements()) {
+    if (element.type() == TLV_ACCESS_OTHER) {
+      other += ndn::readNonNegativeInteger(element);
+      continue;
+    }
+    if (element.type() != TLV_ACCESS_PREFIX)
+      continue;                                   // unknown: skip, forward compatible
+
+    element.parse();
+    auto it = element.elements_begin();
+    if (it == element.elements_end() || it->type() != ndn::tlv::Name)
+      NDN_THROW(ndn::tlv::Error("AccessPrefix without Name"));
+    const ndn::Name prefix(*it);
+
+    for (++it; it != element.elements_end(); ++it) {
+      if (it->type() == TLV_ACCESS_SEQ_RUN) {
+        const uint8_t* p   = it->value();
+        const uint8_t* end = p + it->value_size();
+        uint64_t seq = 0;
+        while (p != end) {
+          seq += readLeb128(p, end);
+          uint64_t count = readLeb128(p, end);
+          onEntry(ndn::Name(prefix).appendSequenceNumber(seq), count);
+        }
+      }
+      else if (it->type() == TLV_ACCESS_SUFFIX) {
+        it->parse();
+        if (it->elements_size() != 2)
+          NDN_THROW(ndn::tlv::Error("AccessSuffix must hold a NameComponent and a count"));
+        Component comp(it->elements()[0]);
+        uint64_t count = ndn::readNonNegativeInteger(it->elements()[1]);
+        onEntry(ndn::Name(prefix).append(comp), count);
+      }
+    }
+  }
+  return other;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <ndn-cxx/encoding/block.hpp>
+#include <ndn-cxx/name.hpp>
+#include "fog-tlv.hpp"
+#include "space-saving.hpp"
+
+/** Compact wire format of the node → fog-controller access report.
+ *
+ *    AccessReport = ACCESS-REPORT-TYPE TLV-LENGTH
+ *                     *AccessPrefix
+ *                     [AccessOther]
+ *    AccessPrefix = ACCESS-PREFIX-TYPE TLV-LENGTH
+ *                     Name                    ; shared prefix, sent once
+ *                     [AccessSeqRun]          ; children /<prefix>/seq=N
+ *                     *AccessSuffix           ; any other last component
+ *    AccessSeqRun = ACCESS-SEQ-RUN-TYPE TLV-LENGTH
+ *                     *(LEB128 seq-delta, LEB128 count)   ; seqs ascending
+ *    AccessSuffix = ACCESS-SUFFIX-TYPE TLV-LENGTH NameComponent NonNegativeInteger
+ *    AccessOther  = ACCESS-OTHER-TYPE  TLV-LENGTH NonNegativeInteger
+ *
+ *  Sibling names (/video/seq=N, the usual Zipf catalogue) therefore cost a
+ *  couple of bytes each instead of a full Name plus TLV headers.
+ *
+ *  Reports larger than the configured size are split into several
+ *  AccessReport blocks, each self-contained (prefixes are repeated where a
+ *  group straddles a boundary), meant to travel as the segments of one
+ *  versioned report.  AccessOther is carried by the last segment only.
+ */
+
+/// Encode @p items plus the aggregate @p other.  Every returned block is
+/// at most @p maxBytes long, except when a single entry alone exceeds it.
+std::vector<ndn::Block>
+encodeAccessReport(const std::vector<SpaceSaving::Item>& items, uint64_t other, size_t maxBytes);
+
+/// Decode one AccessReport block, calling @p onEntry for every (name, count).
+/// @return the AccessOther value (0 if absent)
+/// @throw ndn::tlv::Error if the block is malformed
+uint64_t
+decodeAccessReport(const ndn::Block& report,
+                   const std::function<void(const ndn::Name&, uint64_t)>& onEntry);
@@ -0,0 +1,125 @@
+// cache-stats-probe.cpp — per-node CacheStats trace source
+
+#include "cache-stats-probe.hpp"
+
+#include <ns3/node.h>
+#include <ns3/node-list.h>
+#include <ns3/simulator.h>
+#include <ns3/trace-source-accessor.h>
+
+#include <algorithm>
+
+namespace nfd::fw {
+
+NS_OBJECT_ENSURE_REGISTERED(CacheStatsProbe);
+
+namespace {
+
+std::map<uint32_t, ns3::Ptr<CacheStatsProbe>>&
+registry()
+{
+  static std::map<uint32_t, ns3::Ptr<CacheStatsProbe>> probes;
+  return probes;
+}
+
+} // unnamed namespace
+
+ns3::TypeId
+CacheStatsProbe::GetTypeId()
+{
+  static ns3::TypeId tid = ns3::TypeId("ns3::ndn::CacheStatsProbe")
+    .SetParent<ns3::Object>()
+    .SetGroupName("Ndn")
+    .AddConstructor<CacheStatsProbe>()
+    .AddAttribute("Interval", "Time between two Sample traces (0 disables them)",
+                  ns3::TimeValue(ns3::Seconds(1)),
+                  ns3::MakeTimeAccessor(&CacheStatsProbe::m_interval),
+                  ns3::MakeTimeChecker())
+    .AddTraceSource("Sample", "Periodic snapshot of the node's cache counters",
+                    ns3::MakeTraceSourceAccessor(&CacheStatsProbe::m_sampleTrace),
+                    "ns3::ndn::CacheStatsProbe::SampleCallback");
+  return tid;
+}
+
+ns3::Ptr<CacheStatsProbe>
+CacheStatsProbe::forNode(uint32_t nodeId)
+{
+  auto& probes = registry();
+  auto it = probes.find(nodeId);
+  if (it != probes.end())
+    return it->second;
+
+  auto probe = ns3::CreateObject<CacheStatsProbe>();
+  if (nodeId < ns3::NodeList::GetNNodes())
+    ns3::NodeList::GetNode(nodeId)->AggregateObject(probe);
+  probe->start(nodeId);
+  probes.emplace(nodeId, probe);
+  return probe;
+}
+
+const std::map<uint32_t, ns3::Ptr<CacheStatsProbe>>&
+CacheStatsProbe::getRegistry()
+{
+  return registry();
+}
+
+void
+CacheStatsProbe::clearRegistry()
+{
+  for (auto& [id, probe] : registry())
+    probe->m_event.Cancel();
+  registry().clear();
+}
+
+uint32_t
+CacheStatsProbe::addSource(Source source)
+{
+  m_sources.emplace_back(m_nextHandle, std::move(source));
+  return m_nextHandle++;
+}
+
+void
+CacheStatsProbe::removeSource(uint32_t handle)
+{
+  auto it = std::find_if(m_sources.begin(), m_sources.end(),
+                         [handle] (const auto& s) { return s.first == handle; });
+  if (it == m_sources.end())
+    return;
+
+  CacheStats last = it->second();
+  last.bytes = 0;                                // the instance's cache is gone
+  m_retired += last;
+  m_sources.erase(it);
+}
+
+CacheStats
+CacheStatsProbe::sample() const
+{
+  CacheStats total = m_retired;
+  for (const auto& source : m_sources)
+    total += source.second();
+  return total;
+}
+
+void
+CacheStatsProbe::DoDispose()
+{
+  m_event.Cancel();
+  ns3::Object::DoDispose();
+}
+
+void
+CacheStatsProbe::start(uint32_t nodeId)
+{
+  if (!m_interval.IsZero())
+    m_event = ns3::Simulator::ScheduleWithContext(nodeId, m_interval, &CacheStatsProbe::fire, this);
+}
+
+void
+CacheStatsProbe::fire()
+{
+  m_sampleTrace(sample());
+  m_event = ns3::Simulator::Schedule(m_interval, &CacheStatsProbe::fire, this);
+}
+
+} // namespace nfd::fw
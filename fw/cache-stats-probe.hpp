@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+#include <ns3/event-id.h>
+#include <ns3/nstime.h>
+#include <ns3/object.h>
+#include <ns3/ptr.h>
+#include <ns3/traced-callback.h>
+#include "cache-stats.hpp"
+
+namespace nfd::fw {
+
+/** Per-node ns-3 trace source for CacheStats.
+ *
+ *  ─ Aggregated to the ns-3 Node, so tracers find it under
+ *    /NodeList/<id>/$ns3::ndn::CacheStatsProbe/Sample.
+ *  ─ Every strategy instance on the node registers a source; a sample is
+ *    their sum plus what instances destroyed earlier left behind.
+ *  ─ "Sample" fires every Interval (attribute, 0 = never) with a snapshot,
+ *    so the hot path never calls into the tracing system.
+ *  ─ Probes are also kept in a registry that outlives the nodes, for the
+ *    end-of-simulation metric dump.
+ */
+class CacheStatsProbe : public ns3::Object
+{
+public:
+  static ns3::TypeId GetTypeId();
+
+  typedef void (*SampleCallback)(const CacheStats& stats);
+
+  using Source = std::function<CacheStats()>;
+
+  /// Probe of node @p nodeId, created (and aggregated) on first use
+  static ns3::Ptr<CacheStatsProbe> forNode(uint32_t nodeId);
+
+  /// Every probe created since the last clearRegistry(), by node id
+  static const std::map<uint32_t, ns3::Ptr<CacheStatsProbe>>& getRegistry();
+  static void clearRegistry();
+
+  uint32_t   addSource(Source source);
+  /// Fold the final counters of @p handle into the retired total and drop it
+  void       removeSource(uint32_t handle);
+
+  CacheStats sample() const;
+
+protected:
+  void DoDispose() override;
+
+private:
+  void start(uint32_t nodeId);
+  void fire();
+
+private:
+  ns3::TracedCallback<const CacheStats&>   m_sampleTrace;
+  ns3::Time                                m_interval;
+  ns3::EventId                             m_event;
+  std::vector<std::pair<uint32_t, Source>> m_sources;
+  CacheStats                               m_retired;
+  uint32_t                                 m_nextHandle = 0;
+};
+
+} // namespace nfd::fw
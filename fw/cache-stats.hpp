@@ -3,14 +3,38 @@
 
 namespace nfd::fw {
 
+/** Cache counters of one strategy instance or one SlruCache.
+ *
+ *  Plain integers bumped on the hot path; they are only read when a
+ *  CacheStatsProbe samples them.
+ */
 struct CacheStats {
-  uint64_t interests = 0;
-  uint64_t hits      = 0;
-  uint64_t evictions = 0;
-};
+  uint64_t interests  = 0;
+  uint64_t hits       = 0;
+  uint64_t misses     = 0;
+  uint64_t admissions = 0;   ///< Data stored
+  uint64_t rejections = 0;   ///< Data offered but not stored
+  uint64_t evictions  = 0;
+  uint64_t bytes      = 0;   ///< resident Data wire bytes (a level, not a count)
 
-// “extern” means “the real variable lives elsewhere”
-extern CacheStats g_cacheStats;
+  CacheStats&
+  operator+=(const CacheStats& o)
+  {
+    interests  += o.interests;
+    hits       += o.hits;
+    misses     += o.misses;
+    admissions += o.admissions;
+    rejections += o.rejections;
+    evictions  += o.evictions;
+    bytes      += o.bytes;
+    return *this;
+  }
 
-} // namespace nfd::fw
+  double
+  hitRatio() const
+  {
+    return interests > 0 ? static_cast<double>(hits) / interests : 0.0;
+  }
+};
 
+} // namespace nfd::fw
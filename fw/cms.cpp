@@ -1,57 +1,516 @@
 #include "cms.hpp"
+#include "fog-tlv.hpp"
 
-#include <algorithm>     // std::min
-#include <functional>    // std::hash
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+#include <ndn-cxx/encoding/tlv.hpp>
+
+#include <algorithm>     // std::min, std::clamp, std::count_if
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
 #include <string>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CMS_HAVE_X86_SIMD 1
+#endif
+
 namespace {
 
-/** Fixed 32-bit odd constant (fraction of golden ratio) for mix */
-constexpr uint32_t PRIME = 0x9E3779B9u;
+constexpr std::size_t CACHE_LINE = 64;
+constexpr std::size_t COMPACT_MAX_DEPTH = 16;   // conservative update keeps per-row state on the stack
+
+/** Kirsch–Mitzenmacher: g_i(x) = h1(x) + i·h2(x).  h2 is forced odd so the
+ *  sequence visits distinct columns of a power-of-two-wide row. */
+inline uint32_t h1Of(NameDigest d) { return static_cast<uint32_t>(d); }
+inline uint32_t h2Of(NameDigest d) { return static_cast<uint32_t>(d >> 32) | 1u; }
+
+void
+appendLeb128(std::vector<uint8_t>& out, uint64_t v)
+{
+  while (v >= 0x80) {
+    out.push_back(static_cast<uint8_t>(v) | 0x80);
+    v >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(v));
+}
+
+size_t
+leb128Size(uint64_t v)
+{
+  size_t n = 1;
+  for (; v >= 0x80; v >>= 7)
+    ++n;
+  return n;
+}
+
+uint64_t
+readLeb128(const uint8_t*& p, const uint8_t* end)
+{
+  uint64_t v = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    if (p == end)
+      NDN_THROW(ndn::tlv::Error("Sketch: truncated row"));
+    uint8_t b = *p++;
+    v |= static_cast<uint64_t>(b & 0x7F) << shift;
+    if ((b & 0x80) == 0)
+      return v;
+  }
+  NDN_THROW(ndn::tlv::Error("Sketch: oversized counter"));
+}
+
+/** Validate a Sketch TLV (shape within MAX_WIRE_COUNTERS, every row run
+ *  inside it) and return its depth and width; leaves @p block parsed. */
+std::pair<uint64_t, uint64_t>
+checkSketch(const ndn::Block& block)
+{
+  if (block.type() != TLV_SKETCH)
+    NDN_THROW(ndn::tlv::Error("Expecting Sketch, got TLV-TYPE " + std::to_string(block.type())));
+
+  block.parse();
+  auto it = block.elements_begin();
+  if (it == block.elements_end() || it->type() != TLV_SKETCH_DEPTH)
+    NDN_THROW(ndn::tlv::Error("Sketch: missing depth"));
+  const uint64_t d = ndn::readNonNegativeInteger(*it++);
+  if (it == block.elements_end() || it->type() != TLV_SKETCH_WIDTH)
+    NDN_THROW(ndn::tlv::Error("Sketch: missing width"));
+  const uint64_t w = ndn::readNonNegativeInteger(*it++);
+  if (d == 0 || d > 64 || w < 16 || w > CountMinSketch::MAX_WIRE_COUNTERS / d || (w & (w - 1)) != 0)
+    NDN_THROW(ndn::tlv::Error("Sketch: unsupported shape"));
+
+  for (; it != block.elements_end(); ++it) {
+    if (it->type() != TLV_SKETCH_ROW)
+      continue;
+    const uint8_t* p   = it->value();
+    const uint8_t* end = p + it->value_size();
+    if (readLeb128(p, end) >= d)
+      NDN_THROW(ndn::tlv::Error("Sketch: row index out of range"));
+    const uint64_t j = readLeb128(p, end);
+    if (p != end && (end[-1] & 0x80) != 0)
+      NDN_THROW(ndn::tlv::Error("Sketch: truncated row"));
+    const auto n = static_cast<uint64_t>(std::count_if(p, end, [] (uint8_t b) { return (b & 0x80) == 0; }));
+    if (j > w || n > w - j)
+      NDN_THROW(ndn::tlv::Error("Sketch: row run past the width"));
+  }
+  return {d, w};
+}
+
+/** Saturating add of a checkSketch()ed block's row runs into a d × @p w
+ *  table; only the columns the runs carry are touched. */
+void
+addSketchRows(const ndn::Block& block, uint32_t* table, uint64_t w)
+{
+  for (auto it = block.elements_begin(); it != block.elements_end(); ++it) {
+    if (it->type() != TLV_SKETCH_ROW)
+      continue;
+    const uint8_t* p   = it->value();
+    const uint8_t* end = p + it->value_size();
+    const uint64_t i = readLeb128(p, end);
+    uint32_t* r = table + i * w + readLeb128(p, end);
+    for (; p != end; ++r)
+      *r = static_cast<uint32_t>(std::min<uint64_t>(uint64_t(*r) + readLeb128(p, end), UINT32_MAX));
+  }
+}
+
+/** Saturating +1: a hot name pins at UINT32_MAX instead of wrapping to 0. */
+inline void bump(uint32_t& c) { c += (c != UINT32_MAX); }
+
+/* --------------------------------------------------------------------- */
+/*  Batch kernels.  Lanes run over digests, rows are walked by adding h2  */
+/*  each step, so no per-row multiply or modulo is needed.                */
+/* --------------------------------------------------------------------- */
+
+void
+estimateBatchScalar(const uint32_t* table, std::size_t depth, std::size_t width, uint32_t mask,
+                    const NameDigest* digests, std::size_t n, uint64_t* out)
+{
+  for (std::size_t k = 0; k < n; ++k) {
+    uint32_t h = h1Of(digests[k]);
+    const uint32_t h2 = h2Of(digests[k]);
+    uint32_t est = UINT32_MAX;
+    for (std::size_t i = 0; i < depth; ++i, h += h2)
+      est = std::min(est, table[i * width + (h & mask)]);
+    out[k] = est;
+  }
+}
+
+void
+incrementBatchScalar(uint32_t* table, std::size_t depth, std::size_t width, uint32_t mask,
+                     const NameDigest* digests, std::size_t n)
+{
+  for (std::size_t k = 0; k < n; ++k) {
+    uint32_t h = h1Of(digests[k]);
+    const uint32_t h2 = h2Of(digests[k]);
+    for (std::size_t i = 0; i < depth; ++i, h += h2)
+      bump(table[i * width + (h & mask)]);
+  }
+}
+
+#ifdef CMS_HAVE_X86_SIMD
+
+// AVX2 is the first x86 level with a gather; without it the scalar kernels
+// are as fast as anything 128-bit lanes would do with four separate loads
+const bool g_haveAvx2 = [] {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") != 0;
+}();
+
+/** Split 8 digests into their low (h1) and high (h2) 32-bit halves. */
+__attribute__((target("avx2"))) inline void
+splitDigests8(const NameDigest* d, __m256i& h1, __m256i& h2)
+{
+  const __m256i perm = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+  __m256i a = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(d)), perm);
+  __m256i b = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(d + 4)), perm);
+  h1 = _mm256_permute2x128_si256(a, b, 0x20);
+  h2 = _mm256_or_si256(_mm256_permute2x128_si256(a, b, 0x31), _mm256_set1_epi32(1));
+}
+
+__attribute__((target("avx2"))) void
+estimateBatchAvx2(const uint32_t* table, std::size_t depth, std::size_t width, uint32_t mask,
+                  const NameDigest* digests, std::size_t n, uint64_t* out)
+{
+  const __m256i vmask = _mm256_set1_epi32(static_cast<int>(mask));
+  std::size_t k = 0;
+  for (; k + 8 <= n; k += 8) {
+    __m256i h, h2;
+    splitDigests8(digests + k, h, h2);
 
-/** Cheap per-row mix: xor with a unique 32-bit seed */
-inline std::size_t
-mix(std::size_t base, uint32_t seed)
+    __m256i est = _mm256_set1_epi32(-1);                 // UINT32_MAX
+    __m256i rowOff = _mm256_setzero_si256();
+    const __m256i vwidth = _mm256_set1_epi32(static_cast<int>(width));
+    for (std::size_t i = 0; i < depth; ++i) {
+      __m256i idx = _mm256_add_epi32(_mm256_and_si256(h, vmask), rowOff);
+      __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int*>(table), idx, 4);
+      est = _mm256_min_epu32(est, v);
+      h = _mm256_add_epi32(h, h2);
+      rowOff = _mm256_add_epi32(rowOff, vwidth);
+    }
+
+    alignas(32) uint32_t tmp[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(tmp), est);
+    for (int j = 0; j < 8; ++j)
+      out[k + j] = tmp[j];
+  }
+  estimateBatchScalar(table, depth, width, mask, digests + k, n - k, out + k);
+}
+
+__attribute__((target("avx2"))) void
+incrementBatchAvx2(uint32_t* table, std::size_t depth, std::size_t width, uint32_t mask,
+                   const NameDigest* digests, std::size_t n)
 {
-  return base ^ static_cast<std::size_t>(seed);
+  const __m256i vmask = _mm256_set1_epi32(static_cast<int>(mask));
+  std::size_t k = 0;
+  for (; k + 8 <= n; k += 8) {
+    __m256i h, h2;
+    splitDigests8(digests + k, h, h2);
+
+    uint32_t rowOff = 0;
+    for (std::size_t i = 0; i < depth; ++i, rowOff += static_cast<uint32_t>(width)) {
+      alignas(32) uint32_t idx[8];
+      _mm256_store_si256(reinterpret_cast<__m256i*>(idx), _mm256_and_si256(h, vmask));
+      // no scatter in AVX2; scalar bumps also handle duplicate digests in a batch
+      for (int j = 0; j < 8; ++j)
+        bump(table[rowOff + idx[j]]);
+      h = _mm256_add_epi32(h, h2);
+    }
+  }
+  incrementBatchScalar(table, depth, width, mask, digests + k, n - k);
 }
 
+#endif // CMS_HAVE_X86_SIMD
+
 } // unnamed namespace
 /* --------------------------------------------------------------------- */
 
+void
+FrequencySketch::incrementBatch(const NameDigest* digests, std::size_t n)
+{
+  for (std::size_t k = 0; k < n; ++k)
+    increment(digests[k]);
+}
+
+void
+FrequencySketch::estimateBatch(const NameDigest* digests, std::size_t n, uint64_t* out) const
+{
+  for (std::size_t k = 0; k < n; ++k)
+    out[k] = estimate(digests[k]);
+}
+
+/* --------------------------------------------------------------------- */
+
 CountMinSketch::CountMinSketch(std::size_t d, std::size_t w)
   : m_depth(d)
-  , m_width(w)
-  , m_table(d, std::vector<uint32_t>(w, 0))
-  , m_seed(d)
+  , m_width(16)                   // ≥ one cache line of counters per row
+  , m_mask(0)
 {
-  for (std::size_t i = 0; i < m_depth; ++i)
-    m_seed[i] = static_cast<uint32_t>((i + 1) * PRIME);
+  assert(m_depth > 0);
+  while (m_width < w)
+    m_width <<= 1;
+  m_mask = static_cast<uint32_t>(m_width - 1);
+  assert(m_depth * m_width <= INT32_MAX);   // gather indices are int32
+
+  const std::size_t bytes = m_depth * m_width * sizeof(uint32_t);
+  m_table.reset(static_cast<uint32_t*>(::operator new[](bytes, std::align_val_t(CACHE_LINE))));
+  std::memset(m_table.get(), 0, bytes);
 }
 
+/* Single-digest paths stay scalar: with d ≈ 4 rows a gather costs more
+   than the four independent loads it would replace. */
 void
-CountMinSketch::increment(const ndn::Name& name)
+CountMinSketch::increment(NameDigest digest)
 {
-  const std::string key  = name.toUri();                // TLV→URI once
-  const std::size_t base = std::hash<std::string>{}(key);
+  uint32_t h = h1Of(digest);
+  const uint32_t h2 = h2Of(digest);
+  for (std::size_t i = 0; i < m_depth; ++i, h += h2)
+    bump(m_table[i * m_width + (h & m_mask)]);
 
-  for (std::size_t i = 0; i < m_depth; ++i) {
-    std::size_t idx = mix(base, m_seed[i]) % m_width;
-    ++m_table[i][idx];
-  }
+  countIncrements(1);
 }
 
 uint64_t
-CountMinSketch::estimate(const ndn::Name& name) const
+CountMinSketch::estimate(NameDigest digest) const
 {
-  const std::string key  = name.toUri();
-  const std::size_t base = std::hash<std::string>{}(key);
+  uint32_t h = h1Of(digest);
+  const uint32_t h2 = h2Of(digest);
+  uint32_t est = UINT32_MAX;
+  for (std::size_t i = 0; i < m_depth; ++i, h += h2)
+    est = std::min(est, m_table[i * m_width + (h & m_mask)]);
+  return est;
+}
 
-  uint64_t est = UINT64_MAX;
+void
+CountMinSketch::incrementBatch(const NameDigest* digests, std::size_t n)
+{
+#ifdef CMS_HAVE_X86_SIMD
+  if (g_haveAvx2)
+    incrementBatchAvx2(m_table.get(), m_depth, m_width, m_mask, digests, n);
+  else
+#endif
+  incrementBatchScalar(m_table.get(), m_depth, m_width, m_mask, digests, n);
+
+  countIncrements(n);   // aging is checked once per batch, not per digest
+}
+
+void
+CountMinSketch::estimateBatch(const NameDigest* digests, std::size_t n, uint64_t* out) const
+{
+#ifdef CMS_HAVE_X86_SIMD
+  if (g_haveAvx2)
+    return estimateBatchAvx2(m_table.get(), m_depth, m_width, m_mask, digests, n, out);
+#endif
+  estimateBatchScalar(m_table.get(), m_depth, m_width, m_mask, digests, n, out);
+}
+
+void
+CountMinSketch::halve()
+{
+  uint32_t* t = m_table.get();
+  for (std::size_t i = 0, n = m_depth * m_width; i < n; ++i)   // auto-vectorised
+    t[i] >>= 1;
+  resetIncrements();
+}
+
+void
+CountMinSketch::decay(double factor)
+{
+  // Q16 fixed point keeps the sweep integer-only (and vectorisable)
+  const uint64_t q = static_cast<uint64_t>(std::clamp(factor, 0.0, 1.0) * 65536.0);
+  uint32_t* t = m_table.get();
+  for (std::size_t i = 0, n = m_depth * m_width; i < n; ++i)
+    t[i] = static_cast<uint32_t>((t[i] * q) >> 16);
+}
+
+void
+CountMinSketch::clear()
+{
+  std::memset(m_table.get(), 0, m_depth * m_width * sizeof(uint32_t));
+  resetIncrements();
+}
+
+void
+CountMinSketch::merge(const CountMinSketch& other)
+{
+  if (other.m_depth != m_depth || other.m_width != m_width)
+    throw std::invalid_argument("CountMinSketch::merge: shape mismatch");
+
+  uint32_t* __restrict t = m_table.get();
+  const uint32_t* __restrict o = other.m_table.get();
+  for (std::size_t i = 0, n = m_depth * m_width; i < n; ++i) {   // auto-vectorised
+    uint32_t sum = t[i] + o[i];
+    t[i] = sum < t[i] ? UINT32_MAX : sum;                           // saturate
+  }
+}
+
+/* --------------------------------------------------------------------- */
+/*  Wire format (fog-tlv.hpp):                                           */
+/*    Sketch = SKETCH DEPTH WIDTH *ROW,                                  */
+/*    ROW = LEB128 index, LEB128 first column, LEB128 counters           */
+/* --------------------------------------------------------------------- */
+
+std::vector<ndn::Block>
+CountMinSketch::wireEncode(std::size_t maxSize) const
+{
+  if (maxSize < MIN_WIRE_SIZE)
+    NDN_THROW(std::invalid_argument("CountMinSketch::wireEncode: maxSize below " +
+                                    std::to_string(MIN_WIRE_SIZE)));
+
+  // TLV-LENGTHs are bounded by maxSize, so sizing them for it never undercounts
+  const std::size_t tlHeader = ndn::tlv::sizeOfVarNumber(TLV_SKETCH) +
+                               ndn::tlv::sizeOfVarNumber(maxSize);
+  const std::size_t shape = 4 + ndn::tlv::sizeOfNonNegativeInteger(m_depth) +
+                            ndn::tlv::sizeOfNonNegativeInteger(m_width);
+
+  std::vector<ndn::Block> blocks;
+  std::vector<std::vector<uint8_t>> rows;     // row runs of the block being filled
+  std::size_t used = tlHeader + shape;
+
+  auto flush = [&] {
+    ndn::EncodingBuffer enc;
+    size_t len = 0;
+    for (auto it = rows.rbegin(); it != rows.rend(); ++it)
+      len += ndn::encoding::prependByteArrayBlock(enc, TLV_SKETCH_ROW, it->data(), it->size());
+    len += ndn::encoding::prependNonNegativeIntegerBlock(enc, TLV_SKETCH_WIDTH, m_width);
+    len += ndn::encoding::prependNonNegativeIntegerBlock(enc, TLV_SKETCH_DEPTH, m_depth);
+    len += enc.prependVarNumber(len);
+    len += enc.prependVarNumber(TLV_SKETCH);
+    blocks.push_back(enc.block());
+    rows.clear();
+    used = tlHeader + shape;
+  };
+
+  std::vector<uint8_t> run;
   for (std::size_t i = 0; i < m_depth; ++i) {
-    std::size_t idx = mix(base, m_seed[i]) % m_width;
-    est = std::min<uint64_t>(est, m_table[i][idx]);
+    const uint32_t* r = m_table.get() + i * m_width;
+    std::size_t j = 0;
+    while (j < m_width) {
+      run.clear();
+      appendLeb128(run, i);
+      appendLeb128(run, j);
+      if (!rows.empty() && used + tlHeader + run.size() + leb128Size(r[j]) > maxSize)
+        flush();
+      // an emptied block always takes a counter: MIN_WIRE_SIZE covers the headers
+      do {
+        appendLeb128(run, r[j]);
+        ++j;
+      } while (j < m_width && used + tlHeader + run.size() + leb128Size(r[j]) <= maxSize);
+      used += tlHeader + run.size();
+      rows.push_back(run);
+    }
+  }
+  if (!rows.empty())
+    flush();
+  return blocks;
+}
+
+CountMinSketch
+CountMinSketch::wireDecode(const ndn::Block& block)
+{
+  const auto [d, w] = checkSketch(block);   // before the header sizes a table
+  CountMinSketch sketch(d, w);
+  addSketchRows(block, sketch.m_table.get(), w);
+  return sketch;
+}
+
+void
+CountMinSketch::mergeWire(const ndn::Block& block)
+{
+  const auto [d, w] = checkSketch(block);
+  if (d != m_depth || w != m_width)
+    NDN_THROW(ndn::tlv::Error("Sketch: shape mismatch"));
+  addSketchRows(block, m_table.get(), w);
+}
+
+/* --------------------------------------------------------------------- */
+/*  Compact sketch: 4/8-bit counters, conservative update                */
+/* --------------------------------------------------------------------- */
+
+CompactCountMinSketch::CompactCountMinSketch(std::size_t d, std::size_t w, unsigned bits)
+  : m_depth(std::min(d, COMPACT_MAX_DEPTH))
+  , m_width(16)                   // ≥ one word of counters per row
+  , m_mask(0)
+  , m_bits(bits == 4 ? 4 : 8)
+  , m_perWordLog2(m_bits == 4 ? 4 : 3)
+  , m_max((uint64_t(1) << m_bits) - 1)
+  , m_halveMask(m_bits == 4 ? 0x7777777777777777ull : 0x7F7F7F7F7F7F7F7Full)
+{
+  assert(m_depth > 0);
+  assert(bits == 4 || bits == 8);
+  while (m_width < w)
+    m_width <<= 1;
+  m_mask = static_cast<uint32_t>(m_width - 1);
+  m_words.assign(m_depth * (m_width >> m_perWordLog2), 0);
+}
+
+inline void
+CompactCountMinSketch::locate(std::size_t row, uint32_t h, std::size_t& word, unsigned& shift) const
+{
+  const uint32_t col = h & m_mask;
+  word  = row * (m_width >> m_perWordLog2) + (col >> m_perWordLog2);
+  shift = (col & ((1u << m_perWordLog2) - 1)) * m_bits;
+}
+
+void
+CompactCountMinSketch::increment(NameDigest digest)
+{
+  std::size_t word[COMPACT_MAX_DEPTH];
+  unsigned    shift[COMPACT_MAX_DEPTH];
+
+  // pass 1: locate every row's counter and find the current minimum
+  uint32_t h = h1Of(digest);
+  const uint32_t h2 = h2Of(digest);
+  uint64_t minVal = m_max;
+  for (std::size_t i = 0; i < m_depth; ++i, h += h2) {
+    locate(i, h, word[i], shift[i]);
+    minVal = std::min(minVal, (m_words[word[i]] >> shift[i]) & m_max);
+  }
+
+  // pass 2: conservative update – only the minimal rows move
+  if (minVal < m_max) {
+    for (std::size_t i = 0; i < m_depth; ++i) {
+      if (((m_words[word[i]] >> shift[i]) & m_max) == minVal)
+        m_words[word[i]] += uint64_t(1) << shift[i];
+    }
+  }
+
+  countIncrements(1);
+}
+
+uint64_t
+CompactCountMinSketch::estimate(NameDigest digest) const
+{
+  uint32_t h = h1Of(digest);
+  const uint32_t h2 = h2Of(digest);
+  uint64_t est = m_max;
+  for (std::size_t i = 0; i < m_depth; ++i, h += h2) {
+    std::size_t word;
+    unsigned shift;
+    locate(i, h, word, shift);
+    est = std::min(est, (m_words[word] >> shift) & m_max);
   }
   return est;
 }
 
+void
+CompactCountMinSketch::halve()
+{
+  for (uint64_t& w : m_words)     // all counters of a word in one shift
+    w = (w >> 1) & m_halveMask;
+  resetIncrements();
+}
+
+void
+CompactCountMinSketch::decay(double factor)
+{
+  const uint64_t q = static_cast<uint64_t>(std::clamp(factor, 0.0, 1.0) * 65536.0);
+  for (uint64_t& w : m_words) {
+    if (w == 0)
+      continue;
+    uint64_t out = 0;
+    for (unsigned s = 0; s < 64; s += m_bits)
+      out |= ((((w >> s) & m_max) * q) >> 16) << s;
+    w = out;
+  }
+}
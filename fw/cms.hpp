@@ -1,29 +1,197 @@
 #ifndef CMS_HPP
 #define CMS_HPP
 
-#include <vector>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+#include <ndn-cxx/encoding/block.hpp>
 #include <ndn-cxx/name.hpp>
+#include "name-digest.hpp"
 
-/** Simple Count–Min Sketch for positive-integer frequencies. */
-class CountMinSketch
+/** Approximate per-name frequency counter used for cache admission.
+ *
+ *  Implementations share Kirsch–Mitzenmacher row indexing (h1 + i·h2 over
+ *  a power-of-two width) and the aging policy: halve() after every
+ *  `halvingPeriod` increments, plus caller-driven decay().
+ */
+class FrequencySketch
+{
+public:
+  virtual ~FrequencySketch() = default;
+
+  void     increment(const ndn::Name& name) { increment(computeNameDigest(name)); }
+  uint64_t estimate (const ndn::Name& name) const { return estimate(computeNameDigest(name)); }
+
+  /** Same, keyed by a precomputed digest (no re-hashing of the Name). */
+  virtual void     increment(NameDigest digest) = 0;
+  virtual uint64_t estimate (NameDigest digest) const = 0;
+
+  /** Batch forms: @p n digests at once; @p out receives n estimates.
+      The defaults just loop over the single-digest calls. */
+  virtual void     incrementBatch(const NameDigest* digests, std::size_t n);
+  virtual void     estimateBatch (const NameDigest* digests, std::size_t n, uint64_t* out) const;
+
+  /** Halve every counter (TinyLFU "reset"), so old popularity fades. */
+  virtual void     halve() = 0;
+
+  /** Scale every counter by @p factor ∈ [0,1]; one step of exponential
+      decay, driven by the caller's clock. */
+  virtual void     decay(double factor) = 0;
+
+  /** Aging: halve() automatically after every @p n increments (0 = never).
+      Counters saturate rather than wrap. */
+  void     setHalvingPeriod(uint64_t n) { m_halvingPeriod = n; m_increments = 0; }
+  uint64_t getHalvingPeriod() const { return m_halvingPeriod; }
+
+  virtual std::size_t depth() const = 0;
+  virtual std::size_t width() const = 0;
+  /** Bytes held by the counter table. */
+  virtual std::size_t memoryUsage() const = 0;
+
+protected:
+  /** Account @p n increments; halves once the aging period is reached. */
+  void
+  countIncrements(uint64_t n)
+  {
+    m_increments += n;
+    if (m_halvingPeriod != 0 && m_increments >= m_halvingPeriod)
+      halve();
+  }
+
+  /** To be called from halve(). */
+  void resetIncrements() { m_increments = 0; }
+
+private:
+  uint64_t m_halvingPeriod = 0;
+  uint64_t m_increments    = 0;   ///< since last halve()
+};
+
+/** Simple Count–Min Sketch for positive-integer frequencies.
+ *
+ *  All d rows live in one contiguous, cache-line-aligned block of uint32
+ *  counters.  Row indices come from Kirsch–Mitzenmacher double hashing of
+ *  the 64-bit digest (h1 + i·h2), and the width is a power of two so each
+ *  index is a mask, not a modulo.  Batch variants compute indices for
+ *  several digests at once; with AVX2 the estimate gathers 8 digests' counters
+ *  per row in one instruction, the increments stay scalar (no scatter).
+ */
+class CountMinSketch : public FrequencySketch
 {
 public:
   /** @param d depth  (number of hash rows)
-      @param w width  (counters per row) */
+      @param w width  (counters per row; rounded up to a power of two) */
   CountMinSketch(std::size_t d, std::size_t w);
 
-  void     increment(const ndn::Name& name);
-  uint64_t estimate (const ndn::Name& name) const;
+  using FrequencySketch::increment;
+  using FrequencySketch::estimate;
+
+  void     increment(NameDigest digest) override;
+  uint64_t estimate (NameDigest digest) const override;
+
+  void     incrementBatch(const NameDigest* digests, std::size_t n) override;
+  void     estimateBatch (const NameDigest* digests, std::size_t n, uint64_t* out) const override;
+
+  void     halve() override;
+  void     decay(double factor) override;
+
+  /** Zero every counter (start of a new delta window). */
+  void     clear();
+
+  /** Element-wise (saturating) add of @p other, which must have the same
+      shape; merging per-node delta sketches yields the sketch of the union.
+      @throw std::invalid_argument on a shape mismatch */
+  void     merge(const CountMinSketch& other);
+
+  /** Encode the sketch as Sketch TLVs (see fog-tlv.hpp) of at most
+      @p maxSize bytes each; counters are LEB128 varints, so mostly-zero
+      rows stay small.  A row that does not fit is split into column runs
+      across blocks.  Counters a block leaves out decode as zero, which is
+      neutral for merge(), so the blocks may be shipped one per packet.
+      @throw std::invalid_argument if @p maxSize < MIN_WIRE_SIZE */
+  std::vector<ndn::Block> wireEncode(std::size_t maxSize = SIZE_MAX) const;
+
+  /// smallest block budget wireEncode() accepts (shape plus one counter)
+  static constexpr std::size_t MIN_WIRE_SIZE = 64;
+
+  /// largest d × w wireDecode() accepts: the widest report sketch
+  /// (report-sketch-width~1048576, 4 rows), 16 MiB of counters
+  static constexpr std::size_t MAX_WIRE_COUNTERS = std::size_t(4) << 20;
+
+  /** Rebuild a sketch from a Sketch TLV.  The shape is read from the wire,
+      so d × w is capped at MAX_WIRE_COUNTERS and every row run is checked
+      against it before the table is allocated.
+      @throw ndn::tlv::Error if the block is malformed */
+  static CountMinSketch wireDecode(const ndn::Block& block);
+
+  /** Saturating add of a Sketch TLV's counters, as merge() with its
+      wireDecode() but touching only the columns the block carries, so a
+      sketch split over many segments is folded in without a full-size
+      temporary per segment.
+      @throw ndn::tlv::Error if the block is malformed or of another shape */
+  void     mergeWire(const ndn::Block& block);
+
+  std::size_t depth() const override { return m_depth; }
+  std::size_t width() const override { return m_width; }
+  std::size_t memoryUsage() const override { return m_depth * m_width * sizeof(uint32_t); }
 
 private:
+  struct AlignedDelete
+  {
+    void operator()(uint32_t* p) const { ::operator delete[](p, std::align_val_t(64)); }
+  };
+
   /* declaration order == initialiser list order (avoids -Wreorder) */
   std::size_t                                   m_depth;
-  std::size_t                                   m_width;
-  std::vector<std::vector<uint32_t>>            m_table; ///< [d][w] counters
-  std::vector<uint32_t>                         m_seed;  ///< per-row seed
+  std::size_t                                   m_width;   ///< power of two
+  uint32_t                                      m_mask;    ///< m_width - 1
+  std::unique_ptr<uint32_t[], AlignedDelete>    m_table;   ///< row-major [d][w]
 };
 
-#endif // CMS_HPP
+/** Count–Min Sketch with 4- or 8-bit saturating counters packed into
+ *  64-bit words (16 or 8 per word), i.e. 8× or 4× smaller than
+ *  CountMinSketch for the same shape.
+ *
+ *  Uses conservative update: only the rows currently holding the minimum
+ *  are bumped, which keeps over-estimation low enough that the narrow
+ *  counters rarely saturate between agings.
+ */
+class CompactCountMinSketch : public FrequencySketch
+{
+public:
+  /** @param d    depth (at most 16)
+      @param w    width (counters per row; rounded up to a power of two ≥ 16)
+      @param bits counter width, 4 or 8 */
+  CompactCountMinSketch(std::size_t d, std::size_t w, unsigned bits);
 
+  using FrequencySketch::increment;
+  using FrequencySketch::estimate;
+
+  void     increment(NameDigest digest) override;
+  uint64_t estimate (NameDigest digest) const override;
+
+  void     halve() override;
+  void     decay(double factor) override;
+
+  std::size_t depth() const override { return m_depth; }
+  std::size_t width() const override { return m_width; }
+  std::size_t memoryUsage() const override { return m_words.size() * sizeof(uint64_t); }
+  unsigned    counterBits() const { return m_bits; }
+
+private:
+  /** word index and bit shift of counter (@p row, @p h & mask) */
+  void locate(std::size_t row, uint32_t h, std::size_t& word, unsigned& shift) const;
+
+private:
+  std::size_t           m_depth;
+  std::size_t           m_width;          ///< power of two
+  uint32_t              m_mask;           ///< m_width - 1
+  unsigned              m_bits;           ///< 4 or 8
+  unsigned              m_perWordLog2;    ///< log2(64 / m_bits)
+  uint64_t              m_max;            ///< saturation value (15 / 255)
+  uint64_t              m_halveMask;      ///< clears each counter's top bit after >> 1
+  std::vector<uint64_t> m_words;          ///< row-major, width / (64/bits) words per row
+};
+
+#endif // CMS_HPP
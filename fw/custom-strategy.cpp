@@ -1,13 +1,16 @@
 // custom-strategy.cpp -------------------------------------------------
 // (Full implementation with metric‑gathering additions: cache & energy)
-// ‑‑ revised to use a shared CacheStats declared in cache‑stats.hpp (hits
-// & evictions are now updated inside slru.cpp; this file only counts
-// Interests).
+// ‑‑ cache statistics are per instance (CacheStats / CacheStatsProbe);
+// energy is accumulated per instance and drained to the node's battery
+// periodically.
 
 #include "custom-strategy.hpp"
-#include "cache-stats.hpp"          // <‑‑ new shared stats header
+#include "cache-stats-probe.hpp"
+#include "access-report.hpp"
+#include "fog-tlv.hpp"
 
 #include "NFD/daemon/common/logger.hpp"
+#include <ndn-cxx/encoding/tlv.hpp>
 #include <ndn-cxx/security/key-chain.hpp>
 #include <vector>
 #include <ns3/simulator.h>
@@ -18,91 +21,65 @@
 // extra standard headers
 #include <cstdint>
 #include <fstream>
+#include <map>
 #include <random>
 #include <algorithm>
+#include <cmath>
 
-// ---------------------------------------------------------------------------
-//  Simple per‑operation energy model (anonymous namespace keeps symbols local)
-// ---------------------------------------------------------------------------
 namespace {
-// Per‑operation energy costs (arbitrary units; tune as needed)
-constexpr double E_INTEREST_RX  = 1.0;
-constexpr double E_INTEREST_TX  = 1.0;
-constexpr double E_DATA_RX      = 2.0;
-constexpr double E_DATA_TX      = 2.0;
-constexpr double E_CACHE_INSERT = 1.5;
-
-// Global vector indexed by ns‑3 NodeId (energy accounting)
-std::vector<double> g_nodeEnergy;
-
-// pull the shared statistics object into this TU
-using nfd::fw::g_cacheStats;
-
-// One‑time initializer that sizes the vector once nodes exist
-struct EnergyInit {
-  EnergyInit() {
-    uint32_t n = ns3::NodeList::GetNNodes();
-    g_nodeEnergy.resize(n, 0.0);
-  }
-} s_energyInit;
-
-// Helper – add energy to the current context/node
-constexpr double UNIT_TO_J = 0.005;          // tune as needed
 
-inline void addEnergy(double units)
+bool isAppFace(const nfd::Face& face)
 {
-  using namespace ns3;
-  uint32_t id = Simulator::GetContext();   // “current node id” for the event
-
-  /* 1. ensure the vector is big enough */
-  if (id >= g_nodeEnergy.size())
-    g_nodeEnergy.resize(id + 1, 0.0);
+  return face.getRemoteUri().toString().rfind("appFace://", 0) == 0;
+}
 
-  g_nodeEnergy[id] += units;
+// App, internal and content-store faces are never neighbours
+bool isLocalFace(const nfd::Face& face)
+{
+  std::string uri = face.getRemoteUri().toString();
+  return uri.rfind("internal://", 0) == 0 ||
+         uri.rfind("appFace://",  0) == 0 ||
+         uri.find("contentstore")    != std::string::npos;
+}
 
-  /* 2. drain the battery, if the node has one */
-  Ptr<Node> node = NodeList::GetNode(id);
-  if (!node)
-    return;
+using nfd::fw::CacheStats;
+using nfd::fw::CacheStatsProbe;
 
-  Ptr<BasicEnergySource> src = node->GetObject<BasicEnergySource>();
-  if (src)
-    src->ConsumeEnergy(units * UNIT_TO_J);
-}
+// one PrintMetrics per simulation run, however many strategy instances
+bool s_metricsScheduled = false;
 
 // -----------------------------------------------------------------------
 //  At‑end‑of‑simulation metric dump helper
 // -----------------------------------------------------------------------
 static void PrintMetrics()
 {
+  s_metricsScheduled = false;
 
-  // 1. cache‑stats.txt
-  std::ofstream cs("metrics/cache-stats.txt");
-cs << "interests " << g_cacheStats.interests                     << '\n'
-   << "hits "      << g_cacheStats.hits                          << '\n'
-   << "misses "    << (g_cacheStats.interests - g_cacheStats.hits) << '\n'
-   << "evictions " << g_cacheStats.evictions                     << '\n';
-
-if (g_cacheStats.interests > 0) {
-  double hitRate = static_cast<double>(g_cacheStats.hits) / g_cacheStats.interests;
-  cs << "hitrate " << hitRate << '\n';          // 0.0 – 1.0
-} else {
-  cs << "hitrate 0\n";
-}
+  // 1. cache-stats-nodes.txt – one row per node
+  CacheStats total;
+  std::ofstream nodes("metrics/cache-stats-nodes.txt");
+  nodes << "node interests hits misses admissions rejections evictions bytes hitrate\n";
+  for (const auto& [nodeId, probe] : CacheStatsProbe::getRegistry()) {
+    const CacheStats s = probe->sample();
+    total += s;
+    nodes << nodeId << ' ' << s.interests << ' ' << s.hits << ' ' << s.misses << ' '
+          << s.admissions << ' ' << s.rejections << ' ' << s.evictions << ' '
+          << s.bytes << ' ' << s.hitRatio() << '\n';
+  }
+  CacheStatsProbe::clearRegistry();
 
+  // 2. cache-stats.txt – network-wide totals
+  std::ofstream cs("metrics/cache-stats.txt");
+  cs << "interests "  << total.interests  << '\n'
+     << "hits "       << total.hits       << '\n'
+     << "misses "     << total.misses     << '\n'
+     << "evictions "  << total.evictions  << '\n'
+     << "admissions " << total.admissions << '\n'
+     << "rejections " << total.rejections << '\n'
+     << "hitrate "    << total.hitRatio() << '\n';          // 0.0 – 1.0
 }
 
-} // anonymous namespace (energy + metrics helpers)
-
-// ---------------------------------------------------------------------------
-//  Module‑wide TLV constants (kept in same anon‑namespace block)
-// ---------------------------------------------------------------------------
-namespace {
-constexpr uint32_t TLV_ACCESS_DELTA  = 0xF0;
-constexpr uint32_t TLV_ACCESS_VECTOR = 0xF1;
-constexpr uint32_t TLV_THETA_VECTOR  = 0xF2;
-constexpr uint32_t TLV_THETA_PAIR    = 0xF3;
-} // anonymous namespace (TLVs)
+} // anonymous namespace (face + metrics helpers)
 
 // ---------------------------------------------------------------------------
 //  Strategy registration boilerplate
@@ -111,10 +88,6 @@ NFD_LOG_INIT(CustomStrategy);
 
 namespace nfd::fw {
 
-// -----------------------------------------------------------------------
-//  Shared statistics object – single definition lives here
-// -----------------------------------------------------------------------
-CacheStats g_cacheStats;
 
 const ndn::Name CustomStrategy::STRATEGY_NAME =
   ndn::Name("/localhost/nfd/strategy/custom").appendVersion(1);
@@ -132,46 +105,468 @@ CustomStrategy::getStrategyName()
 // ---------------------------------------------------------------------------
 CustomStrategy::CustomStrategy(Forwarder& forwarder, const ndn::Name& name)
   : BestRouteStrategy(forwarder)
-  , m_cms(4, 2048)          // 4 rows × 2 KiB each
-  , m_slru(25, 25)           // 5 probation + 5 protected (total 10 entries)
   , m_rng(std::random_device{}())
   , m_uni(0.0, 1.0)
 {
-  this->setInstanceName(name);
+  ParsedInstanceName parsed = parseInstanceName(name);
+  if (!parsed.parameters.empty()) {
+    processParams(parsed.parameters);
+  }
+
+  if (parsed.version && *parsed.version != getStrategyName()[-1].toVersion()) {
+    NDN_THROW(std::invalid_argument(
+      "CustomStrategy does not support version " + std::to_string(*parsed.version)));
+  }
+  this->setInstanceName(makeInstanceName(name, getStrategyName()));
+
+  // faces created before this instance, then the FaceTable's own updates
+  for (Face& face : this->getFaceTable())
+    addNeighbourFace(face);
+  m_addFaceConn = afterAddFace.connect([this] (const Face& face) {
+    if (Face* f = this->getFace(face.getId()))         // the table's non-const handle
+      addNeighbourFace(*f);
+  });
+  m_removeFaceConn = beforeRemoveFace.connect([this] (const Face& face) { removeNeighbourFace(face); });
+
+  // default 4 rows × 2048 counters: 32 KiB wide, 8 / 4 KiB compact
+  if (m_cmsBits == 32)
+    m_cms = std::make_unique<CountMinSketch>(m_cmsDepth, m_cmsWidth);
+  else
+    m_cms = std::make_unique<CompactCountMinSketch>(m_cmsDepth, m_cmsWidth, m_cmsBits);
+
+  if (m_cacheMode == CacheMode::CS && m_admission == Admission::TINYLFU)
+    NDN_THROW(std::invalid_argument("admission~tinylfu requires cache~slru"));
+
+  m_slru = SlruCache(m_slruProb, m_slruProt, m_slruUnit);
+  if (m_cacheMode == CacheMode::CS)
+    m_csEvictConn = this->getCs().getPolicy()->beforeEvict.connect([this] (auto&&) { ++m_stats.evictions; });
+
+  if (m_admission == Admission::TINYLFU) {
+    // window ≈ 1 % of the cache, aging period ≈ 10 × cache size (Einziger et al.),
+    // both in entries; a byte window must still hold one max-size packet
+    const size_t entries = capacityInEntries();
+    size_t window = entries / 100;
+    if (m_slruUnit == SlruCache::CapacityUnit::BYTES)
+      window = std::max<size_t>(window * m_slruEntryBytes, ndn::MAX_NDN_PACKET_SIZE);
+    m_tinyLfu = std::make_unique<WTinyLfu>(*m_cms, m_slru, window, 10 * entries);
+  }
+  else {
+    // same aging period TinyLFU uses (in entries), unless cms-halve~ overrides it
+    m_cms->setHalvingPeriod(m_cmsHalvingPeriod ? *m_cmsHalvingPeriod : 10 * capacityInEntries());
+  }
+
+  if (!m_cmsHalfLife.IsZero())
+    scheduleNextDecay();
+
+  NFD_LOG_DEBUG("cache=" << (m_cacheMode == CacheMode::CS ? "cs" : "slru")
+                << " cms=" << m_cmsDepth << "x" << m_cms->width() << "/" << m_cmsBits << "bit"
+                << " slru=" << m_slruProb << "+" << m_slruProt
+                << (m_slruUnit == SlruCache::CapacityUnit::BYTES ? "B" : "")
+                << " theta-default=" << m_defaultTheta << " theta-forward=" << m_thetaForward
+                << " push=" << m_pushBatchBytes << "B/" << m_pushFlushDelay.GetMilliSeconds() << "ms"
+                << " report-interval=" << m_reportInterval.GetMilliSeconds() << "ms"
+                << " report-format=" << (m_reportFormat == ReportFormat::SKETCH ? "sketch" : "names")
+                << " signing=" << static_cast<int>(m_signing));
+
+  initSigning();
+  m_accessTracker = std::make_unique<SpaceSaving>(m_reportCapacity);
+  static_assert(REPORT_SKETCH_DEPTH * (size_t(1) << 20) <= CountMinSketch::MAX_WIRE_COUNTERS,
+                "the controller must accept the widest report sketch");
+  if (m_reportFormat == ReportFormat::SKETCH)
+    m_reportSketch = std::make_unique<CountMinSketch>(REPORT_SKETCH_DEPTH, m_reportSketchWidth);
   scheduleNextReport();
 
   // Dump metrics when the simulator terminates
-  ns3::Simulator::ScheduleDestroy(&PrintMetrics);
+  if (!s_metricsScheduled) {
+    s_metricsScheduled = true;
+    ns3::Simulator::ScheduleDestroy(&PrintMetrics);
+  }
+}
+
+/// Cache capacity in entries; in byte mode estimated as bytes ÷ slru-entry-bytes
+size_t CustomStrategy::capacityInEntries() const
+{
+  if (m_slruUnit == SlruCache::CapacityUnit::ENTRIES)
+    return m_slru.getCapacity();
+  return std::max<size_t>(m_slru.getCapacity() / m_slruEntryBytes, 1);
 }
 
 // ---------------------------------------------------------------------------
-//  afterReceiveInterest – SLRU hit & upstream forwarding
+//  Instance-name parameters (/localhost/nfd/strategy/custom/v=1/<p>~<v>/...)
 // ---------------------------------------------------------------------------
-void CustomStrategy::afterReceiveInterest(const ndn::Interest&          interest,
-                                          const nfd::FaceEndpoint&      ingress,
-                                          const std::shared_ptr<pit::Entry>& pitEntry)
+void CustomStrategy::processParams(const ndn::PartialName& parsed)
+{
+  for (const auto& component : parsed) {
+    std::string parsedStr(reinterpret_cast<const char*>(component.value()), component.value_size());
+    auto n = parsedStr.find("~");
+    if (n == std::string::npos) {
+      NDN_THROW(std::invalid_argument("Format is <parameter>~<value>"));
+    }
+
+    auto f = parsedStr.substr(0, n);
+    auto s = parsedStr.substr(n + 1);
+    if (f == "cache") {
+      if (s == "slru")
+        m_cacheMode = CacheMode::SLRU;
+      else if (s == "cs")
+        m_cacheMode = CacheMode::CS;
+      else
+        NDN_THROW(std::invalid_argument("Value of cache must be slru or cs"));
+    }
+    else if (f == "admission") {
+      if (s == "cms")
+        m_admission = Admission::CMS;
+      else if (s == "tinylfu")
+        m_admission = Admission::TINYLFU;
+      else
+        NDN_THROW(std::invalid_argument("Value of admission must be cms or tinylfu"));
+    }
+    else if (f == "cms-bits") {
+      // 32: wide uint32 counters; 8 / 4: packed, conservative-update counters
+      if (s == "32" || s == "8" || s == "4")
+        m_cmsBits = static_cast<unsigned>(std::stoul(s));
+      else
+        NDN_THROW(std::invalid_argument("Value of cms-bits must be 32, 8 or 4"));
+    }
+    else if (f == "cms-depth") {
+      m_cmsDepth = parseUint(f, s);
+      if (m_cmsDepth == 0 || m_cmsDepth > 16)
+        NDN_THROW(std::invalid_argument("cms-depth should be between 1 and 16"));
+    }
+    else if (f == "cms-width") {
+      // rounded up to a power of two by the sketch
+      m_cmsWidth = parseUint(f, s);
+      if (m_cmsWidth == 0 || m_cmsWidth > (size_t(1) << 24))
+        NDN_THROW(std::invalid_argument("cms-width should be between 1 and 16777216"));
+    }
+    else if (f == "slru-prob") {
+      m_slruProb = parseUint(f, s);
+      if (m_slruProb == 0)
+        NDN_THROW(std::invalid_argument("slru-prob should be greater than 0"));
+    }
+    else if (f == "slru-prot") {
+      m_slruProt = parseUint(f, s);
+    }
+    else if (f == "slru-unit") {
+      if (s == "entries")
+        m_slruUnit = SlruCache::CapacityUnit::ENTRIES;
+      else if (s == "bytes")
+        m_slruUnit = SlruCache::CapacityUnit::BYTES;
+      else
+        NDN_THROW(std::invalid_argument("Value of slru-unit must be entries or bytes"));
+    }
+    else if (f == "slru-entry-bytes") {
+      m_slruEntryBytes = parseUint(f, s);
+      if (m_slruEntryBytes == 0)
+        NDN_THROW(std::invalid_argument("slru-entry-bytes should be greater than 0"));
+    }
+    else if (f == "theta-default") {
+      m_defaultTheta = parseTheta(f, s);
+    }
+    else if (f == "energy-interest-rx" || f == "energy-interest-tx" ||
+             f == "energy-data-rx" || f == "energy-data-tx" || f == "energy-cache-insert") {
+      // per-operation cost in µJ
+      static const std::map<std::string, EnergyOp> ops = {
+        {"energy-interest-rx", E_INTEREST_RX}, {"energy-interest-tx", E_INTEREST_TX},
+        {"energy-data-rx", E_DATA_RX}, {"energy-data-tx", E_DATA_TX},
+        {"energy-cache-insert", E_CACHE_INSERT}};
+      m_energyCost[ops.at(f)] = static_cast<double>(parseUint(f, s)) * 1e-6;
+    }
+    else if (f == "energy-drain") {
+      // ms between two battery updates
+      auto ms = parseUint(f, s);
+      if (ms == 0)
+        NDN_THROW(std::invalid_argument("energy-drain should be greater than 0"));
+      m_energyDrainPeriod = ns3::MilliSeconds(ms);
+    }
+    else if (f == "theta-ttl") {
+      // seconds an instructed θ lasts unless the instruction says otherwise; 0 = forever
+      m_thetaTtl = ns3::Seconds(static_cast<double>(parseUint(f, s)));
+    }
+    else if (f == "theta-forward") {
+      m_thetaForward = parseTheta(f, s);
+    }
+    else if (f == "push-flush") {
+      // milliseconds a neighbour-push batch may wait before it is sent
+      auto ms = parseUint(f, s);
+      if (ms == 0)
+        NDN_THROW(std::invalid_argument("push-flush should be greater than 0"));
+      m_pushFlushDelay = ns3::MilliSeconds(ms);
+    }
+    else if (f == "push-batch") {
+      // bytes of pushed Data per batch; keeps the batch under the 8800-byte NDN limit
+      m_pushBatchBytes = parseUint(f, s);
+      if (m_pushBatchBytes < 512 || m_pushBatchBytes > 8000)
+        NDN_THROW(std::invalid_argument("push-batch should be between 512 and 8000"));
+    }
+    else if (f == "report-segment") {
+      // max bytes of report payload per Data segment
+      m_reportSegmentBytes = parseUint(f, s);
+      if (m_reportSegmentBytes < 256 || m_reportSegmentBytes > 8000)
+        NDN_THROW(std::invalid_argument("report-segment should be between 256 and 8000"));
+    }
+    else if (f == "report-signing") {
+      if (s == "sha256")
+        m_signing = Signing::SHA256;
+      else if (s == "hmac")
+        m_signing = Signing::HMAC;
+      else if (s == "none")
+        m_signing = Signing::NONE;
+      else if (s == "keychain")
+        m_signing = Signing::KEYCHAIN;
+      else
+        NDN_THROW(std::invalid_argument("Value of report-signing must be sha256, hmac, none or keychain"));
+    }
+    else if (f == "report-hmac-key") {
+      if (s.empty())
+        NDN_THROW(std::invalid_argument("report-hmac-key must not be empty"));
+      m_hmacKey = s;
+    }
+    else if (f == "report-format") {
+      if (s == "names")
+        m_reportFormat = ReportFormat::NAMES;
+      else if (s == "sketch")
+        m_reportFormat = ReportFormat::SKETCH;
+      else
+        NDN_THROW(std::invalid_argument("Value of report-format must be names or sketch"));
+    }
+    else if (f == "report-sketch-width") {
+      // counters per row of the delta sketch (rounded up to a power of two)
+      m_reportSketchWidth = parseUint(f, s);
+      if (m_reportSketchWidth < 16 || m_reportSketchWidth > (size_t(1) << 20))
+        NDN_THROW(std::invalid_argument("report-sketch-width should be between 16 and 1048576"));
+    }
+    else if (f == "report-target") {
+      if (s == "all")
+        m_reportTarget = ReportTarget::ALL;
+      else if (s == "fib")
+        m_reportTarget = ReportTarget::FIB;
+      else
+        NDN_THROW(std::invalid_argument("Value of report-target must be all or fib"));
+    }
+    else if (f == "report-topk") {
+      // names reported individually; the rest are summed into one bucket
+      m_reportTopK = parseUint(f, s);
+      if (m_reportTopK == 0)
+        NDN_THROW(std::invalid_argument("report-topk should be greater than 0"));
+    }
+    else if (f == "report-capacity") {
+      // names monitored per window (fixed memory)
+      m_reportCapacity = parseUint(f, s);
+      if (m_reportCapacity == 0 || m_reportCapacity > (size_t(1) << 24))
+        NDN_THROW(std::invalid_argument("report-capacity should be between 1 and 16777216"));
+    }
+    else if (f == "report-interval") {
+      // milliseconds
+      auto ms = parseUint(f, s);
+      if (ms == 0)
+        NDN_THROW(std::invalid_argument("report-interval should be greater than 0"));
+      m_reportInterval = ns3::MilliSeconds(ms);
+    }
+    else if (f == "cms-halve") {
+      // increments between halvings; 0 disables (ignored under tinylfu,
+      // whose sample period already ages the sketch)
+      m_cmsHalvingPeriod = parseUint(f, s);
+    }
+    else if (f == "cms-half-life") {
+      // seconds; 0 disables time-based decay
+      m_cmsHalfLife = ns3::Seconds(static_cast<double>(parseUint(f, s)));
+    }
+    else {
+      NDN_THROW(std::invalid_argument("Parameter should be cache, admission, cms-bits, cms-depth, cms-width, "
+                                      "cms-halve, cms-half-life, slru-prob, slru-prot, slru-unit, "
+                                      "slru-entry-bytes, "
+                                      "theta-default, theta-ttl, theta-forward, push-flush, push-batch, "
+                                      "report-interval, report-topk, report-capacity, report-segment, "
+                                      "report-format, report-sketch-width, report-target, "
+                                      "report-signing, report-hmac-key, energy-interest-rx, "
+                                      "energy-interest-tx, energy-data-rx, energy-data-tx, "
+                                      "energy-cache-insert or energy-drain"));
+    }
+  }
+}
+
+uint64_t CustomStrategy::parseUint(const std::string& param, const std::string& value)
+{
+  if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos) {
+    NDN_THROW(std::invalid_argument("Value of " + param + " must be a non-negative integer"));
+  }
+  try {
+    return std::stoull(value);
+  }
+  catch (const std::out_of_range&) {
+    NDN_THROW(std::invalid_argument("Value of " + param + " is out of range"));
+  }
+}
+
+/// θ values are given in 1/10000 (the fixed point of the fog instruction TLV)
+double CustomStrategy::parseTheta(const std::string& param, const std::string& value)
+{
+  auto fixed = parseUint(param, value);
+  if (fixed > 10000)
+    NDN_THROW(std::invalid_argument(param + " should be between 0 and 10000 (θ × 10⁴)"));
+  return static_cast<double>(fixed) / 10000.0;
+}
+
+CustomStrategy::~CustomStrategy()
+{
+  drainEnergy();
+  // every periodic event is bound to a raw this
+  m_energyDrainEvent.Cancel();
+  m_reportEvent.Cancel();
+  m_decayEvent.Cancel();
+  m_pushFlushEvent.Cancel();
+  m_thetaExpiryEvent.Cancel();
+  if (auto trace = EnergyTrace::get(); trace && m_energyTraceHandle)
+    trace->removeSource(*m_energyTraceHandle);
+  if (m_statsProbe)
+    m_statsProbe->removeSource(m_statsHandle);   // keep this instance's totals
+}
+
+// ---------------------------------------------------------------------------
+//  Node binding: the strategy is built outside any node context, so the
+//  node-level objects are looked up once, on the first operation.
+// ---------------------------------------------------------------------------
+void CustomStrategy::bindNode()
+{
+  using namespace ns3;
+  m_nodeId = Simulator::GetContext();
+
+  if (m_nodeId < NodeList::GetNNodes())
+    m_energySource = NodeList::GetNode(m_nodeId)->GetObject<BasicEnergySource>();
+  if (m_energySource)
+    m_energyDrainEvent = Simulator::Schedule(m_energyDrainPeriod, &CustomStrategy::drainEnergyTick, this);
+
+  m_statsProbe  = CacheStatsProbe::forNode(m_nodeId);
+  m_statsHandle = m_statsProbe->addSource([this] { return getStats(); });
+
+  if (auto trace = EnergyTrace::get()) {
+    m_energyTraceHandle = trace->addSource(m_nodeId, [this] {
+      EnergyTrace::Sample joules;
+      for (size_t op = 0; op < E_OP_COUNT; ++op)
+        joules[op] = static_cast<double>(m_energyOps[op]) * m_energyCost[op];
+      return joules;
+    });
+  }
+}
+
+// ---------------------------------------------------------------------------
+//  Energy: costs accumulate in m_energyPending and reach the battery in one
+//  ConsumeEnergy() per energy-drain period (or on drainEnergy()).
+// ---------------------------------------------------------------------------
+void CustomStrategy::addEnergy(EnergyOp op)
+{
+  if (m_nodeId == NO_NODE)
+    bindNode();
+  m_energyPending += m_energyCost[op];
+  ++m_energyOps[op];
+}
+
+void CustomStrategy::drainEnergy()
+{
+  if (m_energySource && m_energyPending > 0.0)
+    m_energySource->ConsumeEnergy(m_energyPending);
+  m_energyPending = 0.0;
+}
+
+void CustomStrategy::drainEnergyTick()
+{
+  drainEnergy();
+  m_energyDrainEvent = ns3::Simulator::Schedule(m_energyDrainPeriod,
+                                                &CustomStrategy::drainEnergyTick, this);
+}
+
+CacheStats CustomStrategy::getStats() const
+{
+  CacheStats stats = m_tinyLfu ? m_tinyLfu->getStats() : m_slru.getStats();
+  stats.interests  = m_stats.interests;
+  stats.hits       = m_stats.hits;
+  stats.misses     = m_stats.misses;
+  stats.admissions = m_stats.admissions;
+  stats.rejections = m_stats.rejections;
+  if (m_cacheMode == CacheMode::CS)
+    stats.evictions = m_stats.evictions;
+  return stats;
+}
+
+// ---------------------------------------------------------------------------
+//  beforePitInsert – SLRU hit, answered before the forwarder builds PIT state
+// ---------------------------------------------------------------------------
+bool CustomStrategy::beforePitInsert(const ndn::Interest& interest, const nfd::FaceEndpoint& ingress)
 {
   // Count every Interest arrival
-  ++g_cacheStats.interests;
+  ++m_stats.interests;
 
   // Energy: Interest Rx cost
   addEnergy(E_INTEREST_RX);
 
-  const ndn::Name& name = interest.getName();
+  const NameDigest digest = getNameDigest(interest);   // hashed once, tagged
 
-  // 1. Serve from SLRU (cache hit)
-  if (m_slru.contains(name)) {
-    if (auto dataPtr = m_slru.fetch(name)) {
-      this->sendData(*dataPtr, ingress.face, pitEntry);
-      addEnergy(E_DATA_TX);   // Tx energy for Data (hits counted inside slru.cpp)
-    }
-    return; // no upstream forwarding
+  // cache~cs: the forwarder's CS lookup follows (afterContentStoreHit)
+  if (m_cacheMode == CacheMode::CS)
+    return false;
+
+  // W-TinyLFU counts every access, hit or miss
+  if (m_tinyLfu)
+    m_tinyLfu->recordAccess(digest);
+
+  if (auto dataPtr = m_tinyLfu ? m_tinyLfu->fetch(digest) : m_slru.fetch(digest)) {
+    ++m_stats.hits;
+    this->sendDataWithoutPit(*dataPtr, interest, ingress.face);
+    addEnergy(E_DATA_TX);   // Tx energy for Data
+    return true;            // no PIT entry, no upstream forwarding
   }
+  return false;
+}
+
+// ---------------------------------------------------------------------------
+//  beforeCsInsert – cache~cs: θ_cache decides whether the forwarder's CS
+//  sees the Data at all; its cms_slru policy then gates by frequency
+// ---------------------------------------------------------------------------
+bool CustomStrategy::beforeCsInsert(const ndn::Data& data, const nfd::FaceEndpoint&)
+{
+  if (m_cacheMode != CacheMode::CS)
+    return true;
+
+  if (m_uni(m_rng) >= thetaFor(data.getName())) {
+    ++m_stats.rejections;
+    return false;
+  }
+  ++m_stats.admissions;
+  addEnergy(E_CACHE_INSERT);                    // Energy: cache insert cost
+  return true;
+}
+
+// ---------------------------------------------------------------------------
+//  afterContentStoreHit – cache~cs hit, answered by the forwarder's CS
+// ---------------------------------------------------------------------------
+void CustomStrategy::afterContentStoreHit(const ndn::Data&                   data,
+                                          const nfd::FaceEndpoint&           ingress,
+                                          const std::shared_ptr<pit::Entry>& pitEntry)
+{
+  ++m_stats.hits;
+  BestRouteStrategy::afterContentStoreHit(data, ingress, pitEntry);
+  addEnergy(E_DATA_TX);   // Tx energy for Data
+}
+
+// ---------------------------------------------------------------------------
+//  afterReceiveInterest – cache miss (SLRU or CS): forward upstream
+// ---------------------------------------------------------------------------
+void CustomStrategy::afterReceiveInterest(const ndn::Interest&          interest,
+                                          const nfd::FaceEndpoint&      ingress,
+                                          const std::shared_ptr<pit::Entry>& pitEntry)
+{
+  const ndn::Name& name   = interest.getName();
+  const NameDigest digest = getNameDigest(interest);   // tag set in beforePitInsert
 
-  // 2. Record Interest for periodic report
-  ++m_accessCounter[name].total;
+  ++m_stats.misses;
 
-  // 3. Forward upstream via BestRoute – count Tx energy
+  // 1. Record Interest for periodic report
+  m_accessTracker->record(digest, name);
+  if (m_reportSketch)
+    m_reportSketch->increment(digest);
+
+  // 2. Forward upstream via BestRoute – count Tx energy
   addEnergy(E_INTEREST_TX);
   BestRouteStrategy::afterReceiveInterest(interest, ingress, pitEntry);
 }
@@ -194,36 +589,269 @@ void CustomStrategy::beforeSatisfyInterest(const ndn::Data&                   da
     return;
   }
 
-  // 1. Update frequency sketch
-  m_cms.increment(name);
+  // 1.–2. cache~slru: update frequency sketch (W-TinyLFU already did so per
+  // Interest), then probabilistic admission (θ_cache).  cache~cs: θ_cache ran
+  // in beforeCsInsert, and the CS policy keeps its own sketch.
+  if (m_cacheMode == CacheMode::SLRU) {
+    const NameDigest digest = getNameDigest(data);
+    if (!m_tinyLfu)
+      m_cms->increment(digest);
+    if (m_uni(m_rng) < thetaFor(data.getName()) && admitToCache(data, digest))
+      addEnergy(E_CACHE_INSERT);                // Energy: cache insert cost
+  }
 
-  // 2. Probabilistic cache admission (θ_cache)
-  double theta = m_defaultTheta;
-  if (auto it = m_thetaCache.find(name); it != m_thetaCache.end())
-    theta = it->second;
+  // 3. Probabilistic neighbour push (θ_forward)
+  if (m_uni(m_rng) < m_thetaForward)
+    enqueuePush(data, ingress.face, *pitEntry);
 
-  if (m_uni(m_rng) < theta) {
-    uint64_t estNew  = m_cms.estimate(name);
-    auto     dataPtr = std::make_shared<ndn::Data>(data);
+  // 4. Standard BestRoute downstream satisfaction
+  BestRouteStrategy::beforeSatisfyInterest(data, ingress, pitEntry);
+}
 
-    if (!m_slru.isFull()) {
-      m_slru.insert(name, dataPtr);
-      addEnergy(E_CACHE_INSERT);                // Energy: cache insert cost
+double CustomStrategy::thetaFor(const ndn::Name& name) const
+{
+  return m_thetaTable.lookup(name, m_defaultTheta);
+}
+
+// ---------------------------------------------------------------------------
+//  admitToCache – frequency-based admission; true if the Data was stored
+//
+//  Data reaching the strategy is owned by a shared_ptr (faces decode into
+//  one, Cs::insert depends on it too), so the cache keeps a reference to
+//  the forwarder's packet and its wire buffer rather than a copy.
+// ---------------------------------------------------------------------------
+bool CustomStrategy::admitToCache(const ndn::Data& data, NameDigest digest)
+{
+  const bool stored = m_tinyLfu ? m_tinyLfu->insert(digest, data.shared_from_this())
+                                : admitByFrequency(data, digest);
+  ++(stored ? m_stats.admissions : m_stats.rejections);
+  return stored;
+}
+
+bool CustomStrategy::admitByFrequency(const ndn::Data& data, NameDigest digest)
+{
+  uint64_t estNew = m_cms->estimate(digest);
+
+  // Compare against every entry the insert would displace: in byte mode a
+  // large object may push out several small ones.
+  m_victims.clear();
+  if (!m_slru.selectVictims(m_slru.costOf(data), m_victims))
+    return false;
+
+  m_victimEst.resize(m_victims.size());
+  m_cms->estimateBatch(m_victims.data(), m_victims.size(), m_victimEst.data());
+  uint64_t estVictims = 0;
+  for (uint64_t est : m_victimEst)
+    estVictims += est;
+
+  if (!m_victims.empty() && estVictims > estNew)
+    return false;
+
+  // Eviction counter is incremented inside slru.cpp
+  return m_slru.insert(digest, data.shared_from_this());
+}
+
+// ---------------------------------------------------------------------------
+//  θ_forward neighbour push – sender side (batched per face)
+// ---------------------------------------------------------------------------
+void CustomStrategy::enqueuePush(const ndn::Data& data, const Face& upstream,
+                                 const pit::Entry& pitEntry)
+{
+  const size_t size = data.wireEncode().size();
+  if (size > m_pushBatchBytes) {
+    NFD_LOG_DEBUG("PUSH-SKIP oversize " << data.getName() << " bytes=" << size);
+    return;
+  }
+
+  auto dataPtr = data.shared_from_this();       // batched by reference, see admitToCache
+
+  // neighbours = every remote face except the upstream and the downstreams,
+  // which already hold / are receiving this Data
+  const auto& inRecords = pitEntry.getInRecords();
+  auto isDownstream = [&inRecords] (const Face& face) {
+    return std::any_of(inRecords.begin(), inRecords.end(),
+                       [&face] (const pit::InRecord& in) { return &in.getFace() == &face; });
+  };
+
+  for (Face* face : m_neighbourFaces) {
+    if (face == &upstream || isDownstream(*face))
+      continue;
+
+    PushBatch& batch = m_pushBatches[face->getId()];
+    if (batch.bytes + size > m_pushBatchBytes)
+      flushPushBatch(face->getId(), batch);
+    batch.items.push_back(dataPtr);
+    batch.bytes += size;
+  }
+
+  if (!m_pushFlushEvent.IsRunning())
+    m_pushFlushEvent = ns3::Simulator::Schedule(m_pushFlushDelay,
+                                                &CustomStrategy::flushPushBatches, this);
+}
+
+void CustomStrategy::flushPushBatch(FaceId faceId, PushBatch& batch)
+{
+  if (batch.items.empty())
+    return;
+
+  Face* face = this->getFace(faceId);
+  if (face != nullptr) {
+    ndn::EncodingBuffer payload;
+    for (auto it = batch.items.rbegin(); it != batch.items.rend(); ++it)
+      payload.prependBlock((*it)->wireEncode());
+    payload.prependVarNumber(payload.size());
+    payload.prependVarNumber(TLV_PUSH_BATCH);
+
+    ndn::Name pushName("/cache-push");
+    pushName.appendNumber(ns3::Simulator::GetContext()).appendSequenceNumber(m_pushSeq++);
+
+    auto pkt = std::make_shared<ndn::Data>(pushName);
+    pkt->setContent(payload.block());
+    pkt->setFreshnessPeriod(ndn::time::milliseconds(0));
+    signControl(*pkt);
+
+    face->sendData(*pkt);
+    addEnergy(E_DATA_TX);
+    NFD_LOG_DEBUG("PUSH-SENT face=" << faceId << " items=" << batch.items.size()
+                  << " bytes=" << batch.bytes);
+  }
+
+  batch.items.clear();
+  batch.bytes = 0;
+}
+
+void CustomStrategy::flushPushBatches()
+{
+  for (auto& [faceId, batch] : m_pushBatches)
+    flushPushBatch(faceId, batch);
+}
+
+// ---------------------------------------------------------------------------
+//  θ_forward neighbour push – receiver side (fog control traffic is relayed)
+// ---------------------------------------------------------------------------
+void CustomStrategy::afterReceiveUnsolicitedData(const ndn::Data&         data,
+                                                 const nfd::FaceEndpoint& ingress)
+{
+  static const ndn::Name PUSH_PREFIX("/cache-push");
+  static const ndn::Name FOG_PREFIX("/fog");
+  if (FOG_PREFIX.isPrefixOf(data.getName())) {
+    relayFogControl(data, ingress);
+    return;
+  }
+  if (!PUSH_PREFIX.isPrefixOf(data.getName())) {
+    Strategy::afterReceiveUnsolicitedData(data, ingress);
+    return;
+  }
+
+  addEnergy(E_DATA_RX);
+
+  try {
+    ndn::Block content = data.getContent();
+    content.parse();
+    auto batchIt = content.find(TLV_PUSH_BATCH);
+    if (batchIt == content.elements_end()) {
+      NFD_LOG_WARN("PUSH malformed, ignore");
+      return;
     }
-    else {
-      ndn::Name victim    = m_slru.selectVictim();
-      uint64_t  estVictim = m_cms.estimate(victim);
 
-      if (estVictim <= estNew) {
-        m_slru.insert(name, dataPtr);
-        addEnergy(E_CACHE_INSERT);              // Energy: cache insert cost
-        // Eviction counter is incremented inside slru.cpp
-      }
+    ndn::Block batch = *batchIt;
+    batch.parse();
+    size_t n = 0;
+    for (const ndn::Block& element : batch.elements()) {
+      if (element.type() != ndn::tlv::Data)
+        continue;
+      receivePush(*std::make_shared<ndn::Data>(element));   // caches keep a shared_ptr
+      ++n;
     }
+    NFD_LOG_DEBUG("PUSH-RECEIVED in=" << ingress << " items=" << n);
+  }
+  catch (const ndn::tlv::Error& e) {
+    NFD_LOG_WARN("PUSH malformed (" << e.what() << "), ignore");
   }
+}
 
-  // 3. Standard BestRoute downstream satisfaction
-  BestRouteStrategy::beforeSatisfyInterest(data, ingress, pitEntry);
+void CustomStrategy::receivePush(const ndn::Data& data)
+{
+  // ReceiveProbabilisticPush: θ_cache coin, then the normal admission path
+  if (m_uni(m_rng) >= thetaFor(data.getName()))
+    return;
+
+  if (m_cacheMode == CacheMode::CS) {
+    this->getCs().insert(data, true);           // policy decides; unsolicited
+    ++m_stats.admissions;
+    addEnergy(E_CACHE_INSERT);
+    return;
+  }
+
+  const NameDigest digest = getNameDigest(data);
+  if (!m_tinyLfu)
+    m_cms->increment(digest);
+  if (admitToCache(data, digest))
+    addEnergy(E_CACHE_INSERT);
+}
+
+// ---------------------------------------------------------------------------
+//  Fog control-plane relay: reports climb the FIB toward /fog, and every hop
+//  remembers the face a node's reports arrived on, so the controller's
+//  /fog/instruction/<nodeId> Data retraces that path without PIT state.
+// ---------------------------------------------------------------------------
+void CustomStrategy::relayFogControl(const ndn::Data& data, const nfd::FaceEndpoint& ingress)
+{
+  static const ndn::Name REPORT_PREFIX("/fog/access-report");
+  static const ndn::Name INSTRUCTION_PREFIX("/fog/instruction");
+
+  const ndn::Name& name = data.getName();
+  const bool isReport = REPORT_PREFIX.isPrefixOf(name);
+  if (!isReport && !INSTRUCTION_PREFIX.isPrefixOf(name)) {
+    Strategy::afterReceiveUnsolicitedData(data, ingress);
+    return;
+  }
+
+  addEnergy(E_DATA_RX);                         // also binds m_nodeId
+
+  uint32_t nodeId = 0;
+  try {
+    nodeId = static_cast<uint32_t>(name.at(2).toNumber());
+  }
+  catch (const std::exception&) {
+    NFD_LOG_DEBUG("FOG-RELAY " << name << " carries no node id, drop");
+    return;
+  }
+
+  Face* egress = nullptr;
+  if (isReport) {
+    m_fogReversePath[nodeId] = ingress.face.getId();
+    egress = fogNextHop(&ingress.face);
+  }
+  else if (nodeId == m_nodeId) {
+    receiveFogInstruction(data);
+    return;
+  }
+  else {
+    auto it = m_fogReversePath.find(nodeId);
+    if (it != m_fogReversePath.end())
+      egress = this->getFace(it->second);
+  }
+
+  if (egress == nullptr || egress == &ingress.face) {
+    NFD_LOG_DEBUG("FOG-RELAY " << name << " has no next hop, drop");
+    return;
+  }
+  egress->sendData(data);
+  addEnergy(E_DATA_TX);
+}
+
+/// Cheapest FIB next hop toward /fog other than @p ingress; a local app face
+/// qualifies, as it can only be the controller itself.
+Face* CustomStrategy::fogNextHop(const Face* ingress) const
+{
+  static const ndn::Name FOG_PREFIX("/fog");
+  for (const fib::NextHop& hop : this->getFib().findLongestPrefixMatch(FOG_PREFIX).getNextHops()) {
+    Face& face = hop.getFace();                   // next hops are sorted by cost
+    if (&face != ingress && (isAppFace(face) || !isLocalFace(face)))
+      return &face;
+  }
+  return nullptr;
 }
 
 // ---------------------------------------------------------------------------
@@ -231,89 +859,283 @@ void CustomStrategy::beforeSatisfyInterest(const ndn::Data&                   da
 // ---------------------------------------------------------------------------
 void CustomStrategy::receiveFogInstruction(const ndn::Data& inst)
 {
-  const ndn::Block& payload = inst.getContent();
-  if (!payload.hasWire() || payload.type() != TLV_THETA_VECTOR) {
-    NFD_LOG_WARN("FOG_INSTRUCTION malformed, ignore");
+  // Content = ThetaVector:
+  //   THETA_EPOCH                  strictly increasing; older or equal ⇒ stale
+  //   [THETA_BASE]                 present ⇒ delta on that epoch, else full
+  //   [THETA_TTL]                  default lifetime of the pairs below
+  //   *THETA_PAIR (Name [θ×10⁴] [THETA_TTL])   no θ ⇒ withdraw the prefix
+  ndn::Block vec;
+  uint64_t epoch = 0;
+  std::optional<uint64_t> base;
+  ns3::Time ttl = m_thetaTtl;
+  try {
+    vec = inst.getContent().blockFromValue();
+    if (vec.type() != TLV_THETA_VECTOR)
+      NDN_THROW(ndn::tlv::Error("not a ThetaVector"));
+    vec.parse();
+    auto it = vec.find(TLV_THETA_EPOCH);
+    if (it == vec.elements_end())
+      NDN_THROW(ndn::tlv::Error("missing epoch"));
+    epoch = ndn::readNonNegativeInteger(*it);
+    if ((it = vec.find(TLV_THETA_BASE)) != vec.elements_end())
+      base = ndn::readNonNegativeInteger(*it);
+    if ((it = vec.find(TLV_THETA_TTL)) != vec.elements_end())
+      ttl = ns3::Seconds(static_cast<double>(ndn::readNonNegativeInteger(*it)));
+  }
+  catch (const ndn::tlv::Error& e) {
+    NFD_LOG_WARN("FOG_INSTRUCTION malformed (" << e.what() << "), ignore");
     return;
   }
 
-  ndn::Block seq = payload;
-  seq.parse();
+  if (m_thetaEpoch && epoch <= *m_thetaEpoch) {
+    NFD_LOG_DEBUG("FOG_INSTRUCTION stale epoch=" << epoch << " current=" << *m_thetaEpoch);
+    return;
+  }
+  if (base && base != m_thetaEpoch) {
+    // a delta was lost or reordered: wait for the next full instruction
+    NFD_LOG_DEBUG("FOG_INSTRUCTION delta epoch=" << epoch << " base=" << *base << " not applicable");
+    return;
+  }
 
-  for (const ndn::Block& pair : seq.elements()) {
+  if (!base) {
+    m_thetaTable.clear();
+    m_thetaWheel.clear();
+  }
+
+  const uint64_t now = thetaTick();
+  auto deadlineAfter = [now] (const ns3::Time& life) {
+    if (life.IsZero())
+      return ThetaTable::NEVER;
+    return now + static_cast<uint64_t>((life.GetMilliSeconds() + THETA_TICK_MS - 1) / THETA_TICK_MS);
+  };
+
+  size_t applied = 0;
+  for (const ndn::Block& pair : vec.elements()) {
     if (pair.type() != TLV_THETA_PAIR)
       continue;
 
-    pair.parse();
-    auto it      = pair.elements_begin();
-    ndn::Name name(*it); ++it;
-    uint64_t thetaFixed = ndn::readNonNegativeInteger(*it);
+    try {
+      pair.parse();
+      auto it = pair.elements_begin();
+      if (it == pair.elements_end() || it->type() != ndn::tlv::Name)
+        NDN_THROW(ndn::tlv::Error("ThetaPair without Name"));
+      ndn::Name name(*it);
+
+      auto thetaIt = pair.find(ndn::tlv::NonNegativeInteger);
+      if (thetaIt == pair.elements_end()) {
+        m_thetaTable.erase(name);
+        ++applied;
+        continue;
+      }
+      double theta = std::clamp(static_cast<double>(ndn::readNonNegativeInteger(*thetaIt)) / 10000.0,
+                                0.0, 1.0);
+      auto ttlIt = pair.find(TLV_THETA_TTL);
+      uint64_t deadline = deadlineAfter(ttlIt == pair.elements_end() ? ttl :
+        ns3::Seconds(static_cast<double>(ndn::readNonNegativeInteger(*ttlIt))));
 
-    double theta = std::clamp(static_cast<double>(thetaFixed) / 10000.0, 0.0, 1.0);
-    m_thetaCache[name] = theta;
-    NFD_LOG_INFO("θ_cache updated " << name << " ← " << theta);
+      m_thetaTable.set(name, theta, deadline);
+      if (deadline != ThetaTable::NEVER)
+        m_thetaWheel.schedule(deadline, std::move(name));
+      ++applied;
+    }
+    catch (const ndn::tlv::Error& e) {
+      NFD_LOG_WARN("FOG_INSTRUCTION bad pair (" << e.what() << "), skip");
+    }
   }
+  m_thetaEpoch = epoch;
+
+  NFD_LOG_INFO("θ_cache " << (base ? "delta" : "full") << " epoch=" << epoch
+               << " entries=" << applied << " prefixes=" << m_thetaTable.size());
+
+  if (!m_thetaWheel.empty() && !m_thetaExpiryEvent.IsRunning())
+    m_thetaExpiryEvent = ns3::Simulator::Schedule(ns3::MilliSeconds(THETA_TICK_MS),
+                                                  &CustomStrategy::expireTheta, this);
+}
+
+uint64_t CustomStrategy::thetaTick()
+{
+  return static_cast<uint64_t>(ns3::Simulator::Now().GetMilliSeconds() / THETA_TICK_MS);
+}
+
+void CustomStrategy::expireTheta()
+{
+  const uint64_t now = thetaTick();
+  size_t expired = 0;
+  m_thetaWheel.advance(now, [&] (const ndn::Name& prefix) {
+    if (m_thetaTable.expire(prefix, now))       // false if re-instructed since
+      ++expired;
+  });
+  if (expired > 0)
+    NFD_LOG_DEBUG("θ_cache expired=" << expired << " prefixes=" << m_thetaTable.size());
+
+  if (!m_thetaWheel.empty())
+    m_thetaExpiryEvent = ns3::Simulator::Schedule(ns3::MilliSeconds(THETA_TICK_MS),
+                                                  &CustomStrategy::expireTheta, this);
 }
 
 // ---------------------------------------------------------------------------
-//  Periodic access report (unchanged)
+//  Time-based CMS decay: DECAY_STEPS ticks per half-life, each scaling the
+//  counters by 2^(-1/DECAY_STEPS), so popularity halves every half-life.
 // ---------------------------------------------------------------------------
-void CustomStrategy::scheduleNextReport()
+void CustomStrategy::scheduleNextDecay()
 {
   using namespace ns3;
-  m_reportEvent = Simulator::Schedule(m_reportInterval,
-                                      &CustomStrategy::sendAccessReport, this);
+  m_decayEvent = Simulator::Schedule(Seconds(m_cmsHalfLife.GetSeconds() / DECAY_STEPS),
+                                     &CustomStrategy::decaySketch, this);
 }
 
-void CustomStrategy::sendAccessReport()
+void CustomStrategy::decaySketch()
 {
-  ndn::EncodingBuffer payload;
-  size_t nonZero = 0;
+  static const double factor = std::exp2(-1.0 / DECAY_STEPS);
+  m_cms->decay(factor);
+  scheduleNextDecay();
+}
 
-  for (auto& [name, info] : m_accessCounter) {
-    uint64_t delta = info.total - info.last;
-    if (delta == 0)
-      continue;
+// ---------------------------------------------------------------------------
+//  Control-plane signing: KeyChain and SigningInfo are resolved once per
+//  instance, so a report costs one hash (or nothing) instead of a public-key
+//  signature.
+// ---------------------------------------------------------------------------
+void CustomStrategy::initSigning()
+{
+  using ndn::security::KeyChain;
+  using ndn::security::SigningInfo;
+
+  switch (m_signing) {
+  case Signing::SHA256:
+    m_keyChain    = std::make_shared<KeyChain>("pib-memory:", "tpm-memory:");
+    m_signingInfo = ndn::security::signingWithSha256();
+    break;
+  case Signing::HMAC:
+    m_keyChain = std::make_shared<KeyChain>("pib-memory:", "tpm-memory:");
+    try {
+      m_signingInfo.setSigningHmacKey(m_hmacKey);
+    }
+    catch (const std::exception& e) {
+      NDN_THROW(std::invalid_argument("report-hmac-key is not a valid base64 key: " + std::string(e.what())));
+    }
+    break;
+  case Signing::KEYCHAIN: {
+    // opening the system PIB/TPM is expensive: one instance for all nodes
+    static auto systemKeyChain = std::make_shared<KeyChain>();
+    m_keyChain    = systemKeyChain;
+    m_signingInfo = SigningInfo();
+    break;
+  }
+  case Signing::NONE:
+    m_keyChain.reset();
+    break;
+  }
+}
 
-    nonZero++;
-    info.last = info.total;
+void CustomStrategy::signControl(ndn::Data& data)
+{
+  if (m_signing != Signing::NONE) {
+    m_keyChain->sign(data, m_signingInfo);
+    return;
+  }
 
-    payload.prependVarNumber(delta);
-    payload.prependVarNumber(TLV_ACCESS_DELTA);
-    name.wireEncode(payload);
+  // same placeholder ndnSIM's Producer uses: no crypto at all
+  ndn::Signature signature;
+  ndn::SignatureInfo signatureInfo(static_cast<ndn::tlv::SignatureTypeValue>(255));
+  signature.setInfo(signatureInfo);
+  signature.setValue(ndn::makeNonNegativeIntegerBlock(ndn::tlv::SignatureValue, 0));
+  data.setSignature(signature);
+  data.wireEncode();
+}
+
+// ---------------------------------------------------------------------------
+//  Neighbour face cache
+// ---------------------------------------------------------------------------
+void CustomStrategy::addNeighbourFace(Face& face)
+{
+  if (isLocalFace(face))
+    return;
+  auto pos = std::lower_bound(m_neighbourFaces.begin(), m_neighbourFaces.end(), face.getId(),
+                              [] (const Face* f, FaceId id) { return f->getId() < id; });
+  if (pos == m_neighbourFaces.end() || *pos != &face)
+    m_neighbourFaces.insert(pos, &face);
+}
+
+void CustomStrategy::removeNeighbourFace(const Face& face)
+{
+  m_neighbourFaces.erase(std::remove(m_neighbourFaces.begin(), m_neighbourFaces.end(), &face),
+                         m_neighbourFaces.end());
+  m_pushBatches.erase(face.getId());
+  for (auto it = m_fogReversePath.begin(); it != m_fogReversePath.end(); ) {
+    if (it->second == face.getId())
+      it = m_fogReversePath.erase(it);
+    else
+      ++it;
   }
+}
+
+// ---------------------------------------------------------------------------
+//  Periodic access report
+// ---------------------------------------------------------------------------
+void CustomStrategy::scheduleNextReport()
+{
+  using namespace ns3;
+  m_reportEvent = Simulator::Schedule(m_reportInterval,
+                                      &CustomStrategy::sendAccessReport, this);
+}
 
-  if (nonZero == 0) {
+void CustomStrategy::sendAccessReport()
+{
+  const uint64_t other = m_accessTracker->drain(m_reportTopK, m_reportTop);
+  const size_t nonZero = m_reportTop.size();
+
+  if (nonZero == 0 && other == 0) {
     scheduleNextReport();
     return;
   }
 
-  payload.prependVarNumber(payload.size());
-  payload.prependVarNumber(TLV_ACCESS_VECTOR);
+  // compact encoding, split into self-contained segments of ≤ report-segment bytes
+  std::vector<ndn::Block> segments = encodeAccessReport(m_reportTop, other, m_reportSegmentBytes);
+  if (m_reportSketch) {
+    appendSketchSegments(segments);
+    m_reportSketch->clear();
+  }
 
+  if (m_nodeId == NO_NODE)
+    bindNode();
   ndn::Name rptName("/fog/access-report");
-  rptName.appendVersion();
+  rptName.appendNumber(m_nodeId).appendVersion();
+  const auto finalBlockId = ndn::name::Component::fromSegment(segments.size() - 1);
+
+  // one next hop toward the controller, or every neighbour
+  Face* fibHop = m_reportTarget == ReportTarget::FIB ? fogNextHop(nullptr) : nullptr;
 
-  auto data = std::make_shared<ndn::Data>(rptName);
-  data->setContent(payload.block());
-  data->setFreshnessPeriod(ndn::time::seconds(1));
+  for (size_t seg = 0; seg < segments.size(); ++seg) {
+    auto data = std::make_shared<ndn::Data>(ndn::Name(rptName).appendSegment(seg));
+    data->setContent(segments[seg]);
+    data->setFreshnessPeriod(ndn::time::seconds(1));
+    data->setFinalBlock(finalBlockId);
 
-  static ndn::security::KeyChain keyChain;
-  keyChain.sign(*data);
+    signControl(*data);
 
-  for (auto& face : this->getFaceTable()) {
-    std::string uri = face.getRemoteUri().toString();
-    bool isLocal = uri.rfind("internal://", 0) == 0 ||
-                   uri.rfind("appFace://",  0) == 0 ||
-                   uri.find("contentstore")    != std::string::npos;
-    if (isLocal)
+    if (fibHop != nullptr) {
+      fibHop->sendData(*data);
       continue;
-    face.sendData(*data);
+    }
+    for (Face* face : m_neighbourFaces)
+      face->sendData(*data);
   }
 
-  NFD_LOG_INFO("ACCESS-REPORT sent entries=" << nonZero);
+  NFD_LOG_INFO("ACCESS-REPORT sent entries=" << nonZero << " other=" << other
+               << " segments=" << segments.size());
   scheduleNextReport();
 }
 
+/// Pack the delta sketch into Sketch blocks of ≤ report-segment bytes, rows
+/// split into column runs where needed.  Every block carries the full shape;
+/// counters it leaves out decode as zero, which merge() treats as "no
+/// accesses", so segments merge independently.
+void CustomStrategy::appendSketchSegments(std::vector<ndn::Block>& segments) const
+{
+  for (ndn::Block& block : m_reportSketch->wireEncode(m_reportSegmentBytes))
+    segments.push_back(std::move(block));
+}
+
 } // namespace nfd::fw
 
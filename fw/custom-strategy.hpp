@@ -3,14 +3,30 @@
 #pragma once
 
 #include "NFD/daemon/fw/strategy.hpp" 
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/security/signing-info.hpp>
 #include <ndn-cxx/util/time.hpp>
+#include <ns3/basic-energy-source.h>
 #include <ns3/nstime.h>
 #include <ns3/simulator.h>
 #include <unordered_map>
 #include "fw/best-route-strategy.hpp"
+#include "cache-stats-probe.hpp"
 #include "cms.hpp"
+#include "energy-trace.hpp"
+#include "name-digest.hpp"
 #include "slru.hpp"
+#include "space-saving.hpp"
+#include "theta-table.hpp"
+#include "timer-wheel.hpp"
+#include "tinylfu.hpp"
+#include <array>
+#include <limits>
+#include <memory>
+#include <optional>
 #include <random>
+#include <string>
+#include <vector>
 
 namespace nfd {
 namespace fw {
@@ -19,12 +35,24 @@ class CustomStrategy : public nfd::fw::BestRouteStrategy
 {
 
 private:
-  struct AccessInfo {
-    uint64_t total    = 0;   // ever-seen interests
-    uint64_t last = 0;   // snapshot used by NodeReportApp later
-  };
+  /// Per-window access counts for the fog report, bounded by
+  /// report-capacity~<n> monitored names (top report-topk~<k> sent by name)
+  std::unique_ptr<SpaceSaving> m_accessTracker;
+  size_t                       m_reportCapacity = 1024;
+  size_t                       m_reportTopK     = 100;
+  std::vector<SpaceSaving::Item> m_reportTop;     // scratch for sendAccessReport
+  size_t                       m_reportSegmentBytes = 1200;   // report-segment~<bytes>
 
-  std::unordered_map<ndn::Name, AccessInfo> m_accessCounter;
+  /// report-format~names  : top-K names with counts, the rest as one aggregate
+  /// report-format~sketch : a delta Count-Min Sketch of the whole window plus
+  ///                        the top-K names; constant size whatever the number
+  ///                        of distinct names, merged at the controller by
+  ///                        element-wise addition (CountMinSketch::merge)
+  enum class ReportFormat { NAMES, SKETCH };
+  ReportFormat                 m_reportFormat = ReportFormat::NAMES;
+  static constexpr size_t      REPORT_SKETCH_DEPTH = 4;
+  size_t                       m_reportSketchWidth = 512;     // report-sketch-width~<n>
+  std::unique_ptr<CountMinSketch> m_reportSketch;             // reset every report
 
 public:
   static const ndn::Name STRATEGY_NAME;
@@ -32,6 +60,26 @@ public:
 
   explicit CustomStrategy(Forwarder& forwarder, const ndn::Name& name);
 
+  ~CustomStrategy() override;
+
+  /// This instance's counters; evictions and bytes come from its SLRU
+  /// (cache~cs: evictions are the CS policy's, bytes stay zero)
+  CacheStats getStats() const;
+
+  /// Push the energy accumulated since the last drain to the node's battery
+  /// (call before reading the battery outside the periodic drain)
+  void drainEnergy();
+
+  bool beforePitInsert(const ndn::Interest& interest,
+                       const FaceEndpoint& ingress) override;
+
+  bool beforeCsInsert(const ndn::Data& data,
+                      const FaceEndpoint& ingress) override;
+
+  void afterContentStoreHit(const ndn::Data& data,
+                            const FaceEndpoint& ingress,
+                            const std::shared_ptr<pit::Entry>& pitEntry) override;
+
   void afterReceiveInterest(const ndn::Interest&     interest,
                             const FaceEndpoint& ingress,
                             const std::shared_ptr<pit::Entry>& pitEntry) override;
@@ -39,31 +87,179 @@ public:
   void beforeSatisfyInterest(const ndn::Data& data,
                            const nfd::FaceEndpoint& ingress,
                            const std::shared_ptr<nfd::pit::Entry>& pitEntry) override;
+
+  void afterReceiveUnsolicitedData(const ndn::Data& data,
+                                   const nfd::FaceEndpoint& ingress) override;
   
 private:
+  void processParams(const ndn::PartialName& parsed);
+  static uint64_t parseUint(const std::string& param, const std::string& value);
+  static double   parseTheta(const std::string& param, const std::string& value);
+
   // ---- SLRU + CMS structures --------------------------------------------
-  CountMinSketch           m_cms;
+  /// cache~slru : the strategy's own SlruCache, answered in beforePitInsert (default;
+  ///              scenarios shrink NFD's CS to 1 entry so it does not shadow it)
+  /// cache~cs   : NFD's Content Store is the only cache, run by the cms_slru
+  ///              policy (StackHelper::setPolicy("nfd::cs::cms_slru")); one copy
+  ///              per Data, CanBePrefix / MustBeFresh handled by Cs::find.
+  ///              θ_cache gates on-demand Data in beforeCsInsert and pushed
+  ///              Data before it enters the CS unsolicited.
+  enum class CacheMode { SLRU, CS };
+  CacheMode                m_cacheMode = CacheMode::SLRU;
+  signal::ScopedConnection m_csEvictConn;           // cache~cs: counts CS evictions
+
+  /// admission~cms      : new Data vs. SLRU victim(s) by CMS estimate (default)
+  /// admission~tinylfu  : W-TinyLFU window + doorkeeper in front of the SLRU
+  enum class Admission { CMS, TINYLFU };
+
+  bool admitToCache(const ndn::Data& data, NameDigest digest);   // after the θ_cache coin flip
+  bool admitByFrequency(const ndn::Data& data, NameDigest digest);   // CMS-vs-victims duel
+
+  /// cms-bits~32 (default) | 8 | 4 : CountMinSketch or CompactCountMinSketch
+  /// cms-depth~<d>, cms-width~<w>     : sketch shape (default 4 × 2048)
+  unsigned                 m_cmsBits  = 32;
+  size_t                   m_cmsDepth = 4;
+  size_t                   m_cmsWidth = 2048;
+  std::unique_ptr<FrequencySketch> m_cms;
+
+  /// slru-prob~<n>, slru-prot~<n>     : segment capacities (default 25 + 25)
+  /// slru-unit~entries (default) | bytes
+  /// slru-entry-bytes~<n>             : typical Data wire size (default 1024),
+  ///                                    turns a byte capacity into an entry
+  ///                                    count for the parts sized in entries
+  size_t                   m_slruProb = 25;
+  size_t                   m_slruProt = 25;
+  SlruCache::CapacityUnit  m_slruUnit = SlruCache::CapacityUnit::ENTRIES;
+  size_t                   m_slruEntryBytes = 1024;
+  size_t capacityInEntries() const;
   SlruCache                m_slru;
-  double                   m_thetaForward = 0.2; // unused for now
+  Admission                m_admission = Admission::CMS;
+  std::unique_ptr<WTinyLfu> m_tinyLfu;             // set iff admission~tinylfu
+  std::vector<NameDigest>  m_victims;              // scratch for admission
+  std::vector<uint64_t>    m_victimEst;            // their CMS estimates
+
+  // ── CMS aging ─────────────────────────────────────────────
+  /// cms-halve~<n>        : halve the sketch every n increments (default 10 × capacity
+  ///                        in entries, bytes ÷ slru-entry-bytes under slru-unit~bytes)
+  /// cms-half-life~<sec>  : also decay it exponentially on the ns-3 clock (default off)
+  static constexpr int      DECAY_STEPS = 4;
+  std::optional<uint64_t>   m_cmsHalvingPeriod;
+  ns3::Time                 m_cmsHalfLife{ns3::Seconds(0)};
+  ns3::EventId              m_decayEvent;
+  void scheduleNextDecay();
+  void decaySketch();
+
   std::mt19937_64          m_rng;
   std::uniform_real_distribution<double> m_uni;
 
   // ── θ_cache table & defaults ───────────────────────────────────
-  std::unordered_map<ndn::Name,double> m_thetaCache;      // per-content θ
-  double                                m_defaultTheta = 0.5;  // fallback
+  ThetaTable                            m_thetaTable;     // per-prefix θ, longest match wins
+  double                                m_defaultTheta = 0.5;  // fallback; theta-default~<θ×10⁴>
+  double thetaFor(const ndn::Name& name) const;
+
+  /// Instructions are versioned: a full one (no base) replaces the table, a
+  /// delta applies only on top of the epoch it names.  Entries expire after
+  /// their TTL (instruction's, else theta-ttl~<sec>, 0 = never) on a timer
+  /// wheel of THETA_TICK resolution.
+  static constexpr int64_t  THETA_TICK_MS     = 100;
+  static constexpr size_t   THETA_WHEEL_SLOTS = 1024;      // ≈ 102 s per lap
+  std::optional<uint64_t>   m_thetaEpoch;                  // last applied
+  ns3::Time                 m_thetaTtl{ns3::Seconds(60)};
+  TimerWheel<ndn::Name>     m_thetaWheel{THETA_WHEEL_SLOTS};
+  ns3::EventId              m_thetaExpiryEvent;
+  static uint64_t thetaTick();
+  void expireTheta();
+
+  // ── θ_forward neighbour push (CacheAndSpread / ReceiveProbabilisticPush) ──
+  /// Pushed Data is coalesced per face into one unsolicited /cache-push
+  /// Data, flushed after push-flush~<ms> or once push-batch~<bytes> fills.
+  struct PushBatch
+  {
+    std::vector<std::shared_ptr<const ndn::Data>> items;
+    size_t                                        bytes = 0;   // sum of wire sizes
+  };
+
+  double                   m_thetaForward = 0.2;                // theta-forward~<θ×10⁴>
+  ns3::Time                m_pushFlushDelay{ns3::MilliSeconds(20)};
+  size_t                   m_pushBatchBytes = 4096;
+  std::unordered_map<FaceId, PushBatch> m_pushBatches;
+  ns3::EventId             m_pushFlushEvent;
+  uint64_t                 m_pushSeq = 0;
+  void enqueuePush(const ndn::Data& data, const Face& upstream, const pit::Entry& pitEntry);
+  void flushPushBatch(FaceId faceId, PushBatch& batch);
+  void flushPushBatches();
+  void receivePush(const ndn::Data& data);
+
+  // ── neighbour faces (report and push targets) ─────────────
+  /// Remote faces in FaceId order, classified once when added instead of on
+  /// every report / push; kept current through the FaceTable signals.
+  std::vector<Face*>        m_neighbourFaces;
+  signal::ScopedConnection  m_addFaceConn;
+  signal::ScopedConnection  m_removeFaceConn;
+  void addNeighbourFace(Face& face);
+  void removeNeighbourFace(const Face& face);
+
+  // ── node binding (first operation, in node context) ──────────
+  static constexpr uint32_t     NO_NODE = std::numeric_limits<uint32_t>::max();
+  uint32_t                      m_nodeId = NO_NODE;
+  void bindNode();
+
+  // ── statistics ───────────────────────────────────────────
+  /// Hot-path counters, exported through the node's CacheStatsProbe
+  CacheStats                    m_stats;
+  ns3::Ptr<CacheStatsProbe>     m_statsProbe;
+  uint32_t                      m_statsHandle = 0;
+
+  // ── energy model ─────────────────────────────────────────
+  /// Per-operation costs, energy-<op>~<µJ>; defaults match the former
+  /// fixed 1 / 1 / 2 / 2 / 1.5 units × 5 mJ.  The battery is drained every
+  /// energy-drain~<ms> (default 100) instead of on every operation.
+  /// Operation counts feed the EnergyTrace, when one is installed.
+  std::array<double, E_OP_COUNT> m_energyCost{{0.005, 0.005, 0.010, 0.010, 0.0075}};  // J
+  std::array<uint64_t, E_OP_COUNT> m_energyOps{};
+  std::optional<uint32_t>       m_energyTraceHandle;
+  double                        m_energyPending = 0.0;                  // J not yet drained
+  ns3::Ptr<ns3::BasicEnergySource> m_energySource;                      // null: no battery
+  ns3::Time                     m_energyDrainPeriod{ns3::MilliSeconds(100)};
+  ns3::EventId                  m_energyDrainEvent;
+  void addEnergy(EnergyOp op);
+  void drainEnergyTick();
 
   // ── periodic reporting ─────────────────────────────────────
-  ns3::Time   m_reportInterval{ns3::Seconds(10)};
+  ns3::Time   m_reportInterval{ns3::Seconds(10)};   // report-interval~<ms>
+  /// report-target~all : every neighbour face (default)
+  /// report-target~fib : only the cheapest FIB next hop toward /fog (the
+  ///                     controller's app face on its own node), falling
+  ///                     back to all neighbours while there is no route
+  ///
+  /// Reports are named /fog/access-report/<nodeId>/v=<t>/seg=<n>.  Nodes
+  /// relay other nodes' reports along the FIB and learn the reverse path,
+  /// used to deliver /fog/instruction/<nodeId> from the controller.
+  enum class ReportTarget { ALL, FIB };
+  ReportTarget m_reportTarget = ReportTarget::ALL;
   ns3::EventId m_reportEvent;
   void scheduleNextReport();
   void sendAccessReport();
+  void appendSketchSegments(std::vector<ndn::Block>& segments) const;
+  std::unordered_map<uint32_t, FaceId> m_fogReversePath;   // nodeId → face its reports came from
+  Face* fogNextHop(const Face* ingress) const;
+  void relayFogControl(const ndn::Data& data, const nfd::FaceEndpoint& ingress);
+
+  // ── control-plane signing (access reports, push batches) ─────
+  /// report-signing~sha256 (default) : DigestSha256, no key material
+  /// report-signing~hmac             : HMAC-SHA256 with report-hmac-key~<base64>
+  /// report-signing~none             : placeholder signature (type 255, as ndnSIM apps)
+  /// report-signing~keychain         : default identity of the shared system KeyChain
+  enum class Signing { SHA256, HMAC, NONE, KEYCHAIN };
+  Signing                                  m_signing = Signing::SHA256;
+  std::string                              m_hmacKey = "Zm9nLWNvbnRyb2wtcGxhbmUta2V5";
+  std::shared_ptr<ndn::security::KeyChain> m_keyChain;     // unset for NONE
+  ndn::security::SigningInfo               m_signingInfo;
+  void initSigning();
+  void signControl(ndn::Data& data);
 
   // ── fog-instruction handling  ───────────────────────────
   void receiveFogInstruction(const ndn::Data& inst);
-
-  // ──── application-specific TLV codes for the instruction payload ──────────
-  static constexpr uint32_t TLV_THETA_PAIR   = 0xF2;      // (Name, θ) pair
-  static constexpr uint32_t TLV_THETA_VECTOR = 0xF3;      // sequence of pairs
 };
 } // namespace fw
 } // namespace nfd
@@ -0,0 +1,86 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ns3/event-id.h>
+#include <ns3/nstime.h>
+
+namespace nfd::fw {
+
+/// Operations the strategy's energy model charges for
+enum EnergyOp : uint8_t { E_INTEREST_RX, E_INTEREST_TX, E_DATA_RX, E_DATA_TX,
+                          E_CACHE_INSERT, E_OP_COUNT };
+
+/** Per-node, per-operation energy time series in a compact binary file.
+ *
+ *  Installed once by the scenario (EnergyTrace::InstallAll), like the
+ *  ndnSIM tracers.  Every period it asks each registered strategy instance
+ *  for its cumulative energy per operation type and stores, per node, what
+ *  was spent since the previous period.  Rows are buffered in columns and
+ *  written a block at a time; scratch/energy-trace-dump.cc turns the file
+ *  into CSV.
+ *
+ *    file   = header *block                       (little-endian)
+ *    header = "NDNE" u8 version(=1) u8 nOps(=5) u16 reserved
+ *    block  = u32 nRows
+ *             u32[nRows] time (ms)
+ *             u32[nRows] node id
+ *             nOps × f32[nRows] joules    ; interest rx, interest tx,
+ *                                          ; data rx, data tx, cache insert
+ *
+ *  Idle (node, period) pairs are not written.
+ */
+class EnergyTrace
+{
+public:
+  using Sample = std::array<double, E_OP_COUNT>;   ///< cumulative J per operation
+  using Source = std::function<Sample()>;
+
+  static constexpr size_t BLOCK_ROWS = 4096;
+
+  /// Start tracing to @p file every @p period; flushed at Simulator::Destroy
+  static void InstallAll(const std::string& file, ns3::Time period = ns3::Seconds(1));
+
+  /// The installed trace, or nullptr
+  static EnergyTrace* get();
+
+  uint32_t addSource(uint32_t nodeId, Source source);
+  /// Keep the final totals of @p handle and stop polling it
+  void     removeSource(uint32_t handle);
+
+private:
+  EnergyTrace(const std::string& file, ns3::Time period);
+
+  static void destroy();
+  void tick();
+  void sampleAll();
+  void flush();
+
+private:
+  struct Entry
+  {
+    uint32_t handle;
+    uint32_t node;
+    Source   source;
+  };
+
+  std::ofstream              m_os;
+  ns3::Time                  m_period;
+  ns3::EventId               m_event;
+  std::vector<Entry>         m_sources;
+  uint32_t                   m_nextHandle = 0;
+  std::map<uint32_t, Sample> m_retired;    ///< per node: removed instances
+  std::map<uint32_t, Sample> m_last;       ///< per node: cumulative at the last sample
+
+  // column buffers of the open block
+  std::vector<uint32_t>                       m_time;
+  std::vector<uint32_t>                       m_node;
+  std::array<std::vector<float>, E_OP_COUNT>  m_energy;
+};
+
+} // namespace nfd::fw
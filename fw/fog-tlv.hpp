@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+
+/** Application-specific TLV types of the fog control plane.
+ *
+ *  Shared by the node strategy (reports, pushes, instruction parsing) and
+ *  the fog controller, so both ends agree on one table.  Types stay below
+ *  253 so every TLV-TYPE encodes in a single byte.
+ */
+
+// θ_cache instructions (controller → node), see CustomStrategy::receiveFogInstruction
+constexpr uint32_t TLV_THETA_EPOCH    = 0xE8;   ///< NonNegativeInteger, increases per instruction
+constexpr uint32_t TLV_THETA_BASE     = 0xE9;   ///< NonNegativeInteger: delta applies on this epoch
+constexpr uint32_t TLV_THETA_TTL      = 0xEA;   ///< NonNegativeInteger seconds, 0 = no expiry
+constexpr uint32_t TLV_THETA_PAIR     = 0xF2;   ///< Name [NonNegativeInteger θ×10⁴] [THETA_TTL]
+constexpr uint32_t TLV_THETA_VECTOR   = 0xF3;   ///< THETA_EPOCH THETA_BASE? THETA_TTL? THETA_PAIR*
+
+// θ_forward neighbour push (node → node)
+constexpr uint32_t TLV_PUSH_BATCH     = 0xF4;   ///< sequence of Data
+
+// access reports (node → controller), see access-report.hpp
+constexpr uint32_t TLV_ACCESS_OTHER   = 0xF5;   ///< NonNegativeInteger: accesses outside the top-K
+constexpr uint32_t TLV_ACCESS_REPORT  = 0xF6;   ///< ACCESS_PREFIX* ACCESS_OTHER?
+constexpr uint32_t TLV_ACCESS_PREFIX  = 0xF7;   ///< Name ACCESS_SEQ_RUN? ACCESS_SUFFIX*
+constexpr uint32_t TLV_ACCESS_SEQ_RUN = 0xF8;   ///< LEB128 (seq delta, count) pairs, seqs ascending
+constexpr uint32_t TLV_ACCESS_SUFFIX  = 0xF9;   ///< NameComponent NonNegativeInteger
+
+// delta Count-Min Sketch in sketch-format reports, see CountMinSketch::wireEncode
+constexpr uint32_t TLV_SKETCH         = 0xE0;   ///< SKETCH_DEPTH SKETCH_WIDTH SKETCH_ROW*
+constexpr uint32_t TLV_SKETCH_DEPTH   = 0xE1;   ///< NonNegativeInteger
+constexpr uint32_t TLV_SKETCH_WIDTH   = 0xE2;   ///< NonNegativeInteger (power of two)
+constexpr uint32_t TLV_SKETCH_ROW     = 0xE3;   ///< LEB128 row index, LEB128 first column, then LEB128 counters
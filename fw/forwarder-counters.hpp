@@ -48,6 +48,9 @@ public:
 
   PacketCounter nCsHits;
   PacketCounter nCsMisses;
+
+  PacketCounter nPitInserts;            ///< PIT entries created
+  PacketCounter nStrategyCacheHits;     ///< Interests answered by Strategy::beforePitInsert
 };
 
 } // namespace nfd
@@ -131,6 +131,14 @@ Forwarder::onIncomingInterest(const Interest& interest, const FaceEndpoint& ingr
     return;
   }
 
+  // strategy-owned cache: a hit is answered without any PIT state
+  if (m_strategyChoice.findEffectiveStrategy(interest.getName()).beforePitInsert(interest, ingress)) {
+    NFD_LOG_DEBUG("onIncomingInterest in=" << ingress << " interest=" << interest.getName()
+                  << " strategy-cache-hit");
+    ++m_counters.nStrategyCacheHits;
+    return;
+  }
+
   // strip forwarding hint if Interest has reached producer region
   if (!interest.getForwardingHint().empty() &&
       m_networkRegionTable.isInProducerRegion(interest.getForwardingHint())) {
@@ -140,7 +148,12 @@ Forwarder::onIncomingInterest(const Interest& interest, const FaceEndpoint& ingr
   }
 
   // PIT insert
-  shared_ptr<pit::Entry> pitEntry = m_pit.insert(interest).first;
+  shared_ptr<pit::Entry> pitEntry;
+  bool isNewPitEntry = false;
+  std::tie(pitEntry, isNewPitEntry) = m_pit.insert(interest);
+  if (isNewPitEntry) {
+    ++m_counters.nPitInserts;
+  }
 
   // detect duplicate Nonce in PIT entry
   int dnw = fw::findDuplicateNonce(*pitEntry, interest.getNonce(), ingress.face);
@@ -331,8 +344,9 @@ Forwarder::onIncomingData(const Data& data, const FaceEndpoint& ingress)
     return;
   }
 
-  // CS insert
-  m_cs.insert(data);
+  // CS insert, unless the strategy turns the Data away
+  if (m_strategyChoice.findEffectiveStrategy(*pitMatches.front()).beforeCsInsert(data, ingress))
+    m_cs.insert(data);
 
   std::set<std::pair<Face*, EndpointId>> satisfiedDownstreams;
   std::multimap<std::pair<Face*, EndpointId>, std::shared_ptr<pit::Entry>> unsatisfiedPitEntries;
@@ -413,6 +427,9 @@ Forwarder::onDataUnsolicited(const Data& data, const FaceEndpoint& ingress)
   NFD_LOG_DEBUG("onDataUnsolicited in=" << ingress << " data=" << data.getName()
                 << " decision=" << decision);
   ++m_counters.nUnsolicitedData;
+
+  // dispatch to strategy: after receive unsolicited Data
+  m_strategyChoice.findEffectiveStrategy(data.getName()).afterReceiveUnsolicitedData(data, ingress);
 }
 
 bool
@@ -0,0 +1,66 @@
+#include "name-digest.hpp"
+
+#include <cstring>
+
+namespace {
+
+/* wyhash-style constants (odd, high-entropy 64-bit primes) */
+constexpr uint64_t P0 = 0xa0761d6478bd642full;
+constexpr uint64_t P1 = 0xe7037ed1a0b428dbull;
+constexpr uint64_t P2 = 0x8ebc6af09c88c6e3ull;
+constexpr uint64_t P3 = 0x589965cc75374cc3ull;
+
+/** 64×64→128 multiply, folded back to 64 bits */
+inline uint64_t
+mum(uint64_t a, uint64_t b)
+{
+  __uint128_t r = static_cast<__uint128_t>(a) * b;
+  return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+}
+
+inline uint64_t
+read64(const uint8_t* p)
+{
+  uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+uint64_t
+hashBytes(const uint8_t* p, size_t len)
+{
+  uint64_t h = P0 ^ mum(len, P1);
+
+  size_t n = len;
+  for (; n >= 16; n -= 16, p += 16)
+    h = mum(read64(p) ^ P1, read64(p + 8) ^ h);
+
+  if (n >= 8) {
+    h = mum(read64(p) ^ P2, h ^ P3);
+    n -= 8;
+    p += 8;
+  }
+
+  if (n > 0) {
+    uint64_t tail = 0;
+    std::memcpy(&tail, p, n);
+    h = mum(tail ^ P3, h ^ P1);
+  }
+
+  return mum(h ^ P2, len ^ P0);
+}
+
+} // unnamed namespace
+
+NameDigest
+computeNameDigest(const ndn::Name& name)
+{
+  const ndn::Block& wire = name.wireEncode();   // cached once decoded
+  return hashBytes(wire.wire(), wire.size());
+}
+
+NameDigest
+extendPrefixDigest(NameDigest parent, const ndn::name::Component& comp)
+{
+  return mum(hashBytes(comp.wire(), comp.size()) ^ parent, parent ^ P3);
+}
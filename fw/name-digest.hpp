@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ndn-cxx/name.hpp>
+#include <ndn-cxx/tag.hpp>
+
+/** 64-bit digest of a Name, shared by every per-content structure
+ *  (CMS, SLRU, θ_cache table, access counter).
+ *
+ *  The digest is a fast non-cryptographic hash over the Name's TLV wire
+ *  bytes.  A Name decoded from a packet already holds its wire encoding,
+ *  so no URI string is materialised and the bytes are walked once.
+ */
+using NameDigest = uint64_t;
+
+/// Packet tag carrying the digest of the packet's Name
+using NameDigestTag = ndn::SimpleTag<NameDigest, 0x60000100>;
+
+NameDigest
+computeNameDigest(const ndn::Name& name);
+
+/// Chained per-prefix digest: the digest of prefix + @p comp, given the
+/// digest @p parent of the prefix (ROOT_PREFIX_DIGEST for "/").  Walking a
+/// Name with it yields every prefix digest in one pass over the bytes.
+/// Not comparable with computeNameDigest().
+constexpr NameDigest ROOT_PREFIX_DIGEST = 0x2d358dccaa6c78a5ull;
+
+NameDigest
+extendPrefixDigest(NameDigest parent, const ndn::name::Component& comp);
+
+/// Digest of @p pkt's Name: read from its NameDigestTag, or computed once
+/// and attached so later callers on the same packet reuse it.
+template<typename Packet>
+NameDigest
+getNameDigest(const Packet& pkt)
+{
+  if (auto tag = pkt.template getTag<NameDigestTag>())
+    return tag->get();
+
+  NameDigest digest = computeNameDigest(pkt.getName());
+  pkt.setTag(std::make_shared<NameDigestTag>(digest));
+  return digest;
+}
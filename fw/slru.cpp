@@ -1,8 +1,7 @@
 // slru.cpp — SLRU cache with integrated statistics
-// (hits & evictions now update the shared g_cacheStats counters)
+// (hits, admissions, rejections & evictions counted per instance)
 
 #include "slru.hpp"
-#include "cache-stats.hpp"              // shared stats struct
 #include "NFD/daemon/common/logger.hpp"
 #include <cassert>
 
@@ -10,118 +9,317 @@ NFD_LOG_INIT(slru);
 
 using ndn::Name;
 using ndn::Data;
-using nfd::fw::g_cacheStats;             // shorthand
 
-SlruCache::SlruCache(size_t probationCap, size_t protectedCap)
+SlruCache::SlruCache(size_t probationCap, size_t protectedCap, CapacityUnit unit)
   : m_capProb(probationCap)
   , m_capProt(protectedCap)
+  , m_unit(unit)
 {
   assert(m_capProb + m_capProt > 0);
+
+  // entry mode knows its node count; byte mode starts small and grows
+  const size_t cap = m_unit == CapacityUnit::ENTRIES ? m_capProb + m_capProt : 64;
+  assert(cap < NIL);
+
+  // thread every slab node onto the free list once, up front
+  m_slab.resize(cap);
+  for (size_t i = 0; i < cap; ++i)
+    m_slab[i].next = (i + 1 < cap) ? static_cast<Index>(i + 1) : NIL;
+  m_free = 0;
+
+  // index keeps load factor <= 0.5 so probe chains stay short
+  size_t nBuckets = 8;
+  while (nBuckets < 2 * cap)
+    nBuckets <<= 1;
+  m_buckets.assign(nBuckets, NIL);
+  m_mask = nBuckets - 1;
 }
 
 // ────────────────────────────────────────────────────────────────
-// helpers
+// intrusive list / slab helpers
+void
+SlruCache::pushFront(Segment seg, Index i)
+{
+  List& l = listOf(seg);
+  Node& n = m_slab[i];
+  n.segment = seg;
+  n.prev    = NIL;
+  n.next    = l.head;
+  if (l.head != NIL)
+    m_slab[l.head].prev = i;
+  else
+    l.tail = i;
+  l.head = i;
+  ++l.size;
+  l.bytes += n.bytes;
+}
+
 void
-SlruCache::promoteToProtected(const Name& name, List::iterator lit)
+SlruCache::unlink(Index i)
+{
+  Node& n = m_slab[i];
+  List& l = listOf(n.segment);
+  if (n.prev != NIL) m_slab[n.prev].next = n.next; else l.head = n.next;
+  if (n.next != NIL) m_slab[n.next].prev = n.prev; else l.tail = n.prev;
+  n.prev = n.next = NIL;
+  --l.size;
+  l.bytes -= n.bytes;
+}
+
+SlruCache::Index
+SlruCache::allocNode()
 {
-  m_probList.erase(lit);
-  m_protList.push_front(name);
-  m_store[name].second = m_protList.begin();
+  if (m_free == NIL)
+    grow();
+  Index i = m_free;
+  m_free = m_slab[i].next;
+  return i;
+}
+
+void
+SlruCache::freeNode(Index i)
+{
+  Node& n = m_slab[i];
+  n.data.reset();
+  n.bytes   = 0;
+  n.segment = Segment::FREE;
+  n.prev    = NIL;
+  n.next    = m_free;
+  m_free    = i;
+}
+
+void
+SlruCache::grow()
+{
+  assert(m_unit == CapacityUnit::BYTES);
+  const size_t oldCap = m_slab.size();
+  const size_t newCap = oldCap * 2;
+  assert(newCap < NIL);
+
+  m_slab.resize(newCap);                     // indices stay valid
+  for (size_t i = oldCap; i < newCap; ++i)
+    m_slab[i].next = (i + 1 < newCap) ? static_cast<Index>(i + 1) : m_free;
+  m_free = static_cast<Index>(oldCap);
 
-  if (m_protList.size() > m_capProt) {
-    Name demoted = m_protList.back();
-    m_protList.pop_back();
-    m_probList.push_front(demoted);
-    m_store[demoted].second = m_probList.begin();
+  if (m_buckets.size() < 2 * newCap) {
+    m_buckets.assign(m_buckets.size() * 2, NIL);
+    m_mask = m_buckets.size() - 1;
+    for (size_t i = 0; i < oldCap; ++i)
+      if (m_slab[i].segment != Segment::FREE)
+        indexInsert(static_cast<Index>(i));
   }
 }
 
+// ────────────────────────────────────────────────────────────────
+// open-addressing index
+SlruCache::Index
+SlruCache::findSlot(NameDigest digest) const
+{
+  for (std::size_t pos = digest & m_mask;; pos = (pos + 1) & m_mask) {
+    Index b = m_buckets[pos];
+    if (b == NIL)
+      return NIL;
+    if (m_slab[b].digest == digest)
+      return static_cast<Index>(pos);
+  }
+}
+
+SlruCache::Index
+SlruCache::lookup(NameDigest digest) const
+{
+  Index slot = findSlot(digest);
+  return slot == NIL ? NIL : m_buckets[slot];
+}
+
 void
-SlruCache::ensureCaps()
-{
-  if (isFull()) {
-    if (!m_probList.empty()) {
-      Name victim = m_probList.back();
-      m_probList.pop_back();
-      m_store.erase(victim);
-      ++g_cacheStats.evictions;              // count every removal
-      NFD_LOG_INFO("SLRU-EVICT " << victim);
-    }
-    else if (!m_protList.empty()) {
-      Name victim = m_protList.back();
-      m_protList.pop_back();
-      m_store.erase(victim);
-      ++g_cacheStats.evictions;
-      NFD_LOG_INFO("SLRU-EVICT " << victim);
+SlruCache::indexInsert(Index node)
+{
+  std::size_t pos = m_slab[node].digest & m_mask;
+  while (m_buckets[pos] != NIL)
+    pos = (pos + 1) & m_mask;
+  m_buckets[pos] = node;
+}
+
+void
+SlruCache::indexErase(Index node)
+{
+  std::size_t hole = m_slab[node].digest & m_mask;
+  while (m_buckets[hole] != node)
+    hole = (hole + 1) & m_mask;
+
+  // backward-shift: pull later members of the probe run into the hole
+  for (std::size_t j = (hole + 1) & m_mask; m_buckets[j] != NIL; j = (j + 1) & m_mask) {
+    std::size_t home = m_slab[m_buckets[j]].digest & m_mask;
+    if (((j - home) & m_mask) >= ((j - hole) & m_mask)) {
+      m_buckets[hole] = m_buckets[j];
+      hole = j;
     }
   }
+  m_buckets[hole] = NIL;
+}
+
+// ────────────────────────────────────────────────────────────────
+// segment movement
+void
+SlruCache::promoteToProtected(Index i)
+{
+  unlink(i);
+  pushFront(Segment::PROTECTED, i);
+
+  while (used(m_prot) > m_capProt) {
+    Index demoted = m_prot.tail;
+    unlink(demoted);
+    pushFront(Segment::PROBATION, demoted);
+  }
+}
+
+void
+SlruCache::evictOne()
+{
+  Index victim = m_prob.tail != NIL ? m_prob.tail : m_prot.tail;
+  if (victim == NIL)
+    return;
+
+  NFD_LOG_INFO("SLRU-EVICT " << m_slab[victim].data->getName());
+  erase(victim);
+  ++m_stats.evictions;                       // count every removal
+}
+
+void
+SlruCache::erase(Index i)
+{
+  unlink(i);
+  indexErase(i);
+  freeNode(i);
 }
 
 // ────────────────────────────────────────────────────────────────
 // queries
 bool
-SlruCache::contains(const Name& name) const
+SlruCache::contains(NameDigest digest) const
 {
-  return m_store.find(name) != m_store.end();
+  return lookup(digest) != NIL;
 }
 
 bool
 SlruCache::isFull() const
 {
-  return (m_probList.size() + m_protList.size()) >=
-         (m_capProb + m_capProt);
+  return usedTotal() >= (m_capProb + m_capProt);
+}
+
+size_t
+SlruCache::costOf(const Data& data) const
+{
+  return m_unit == CapacityUnit::BYTES ? data.wireEncode().size() : 1;
+}
+
+bool
+SlruCache::selectVictims(size_t cost, std::vector<NameDigest>& victims) const
+{
+  const size_t cap = m_capProb + m_capProt;
+  if (cost > cap)
+    return false;
+
+  // walk the same order evictOne() would take: probation LRU, then protected LRU
+  size_t have = cap - usedTotal();
+  for (Index i = m_prob.tail; have < cost && i != NIL; i = m_slab[i].prev) {
+    victims.push_back(m_slab[i].digest);
+    have += costOf(i);
+  }
+  for (Index i = m_prot.tail; have < cost && i != NIL; i = m_slab[i].prev) {
+    victims.push_back(m_slab[i].digest);
+    have += costOf(i);
+  }
+  return true;
 }
 
 Name
 SlruCache::selectVictim() const
 {
-  if (!m_probList.empty())  return m_probList.back();
-  if (!m_protList.empty())  return m_protList.back();
+  if (m_prob.tail != NIL)  return m_slab[m_prob.tail].data->getName();
+  if (m_prot.tail != NIL)  return m_slab[m_prot.tail].data->getName();
   return Name();            // empty
 }
 
 // ────────────────────────────────────────────────────────────────
 // insert / fetch
 bool
-SlruCache::insert(const Name& name, const DataPtr& data)
-{
-  auto it = m_store.find(name);
-  if (it != m_store.end()) {
-    it->second.first = data;
-    fetch(name);                  // refresh position
-    NFD_LOG_INFO("SLRU-INSERT " << name);
-    return true;
+SlruCache::insert(NameDigest digest, const DataPtr& data)
+{
+  const size_t bytes = data->wireEncode().size();
+
+  Index slot = findSlot(digest);
+  if (slot != NIL) {
+    Index i = m_buckets[slot];
+    if (m_slab[i].bytes == bytes) {
+      m_slab[i].data = data;
+      if (m_slab[i].segment == Segment::PROBATION)   // refresh position
+        promoteToProtected(i);
+      else {
+        unlink(i);
+        pushFront(Segment::PROTECTED, i);
+      }
+      NFD_LOG_INFO("SLRU-INSERT " << data->getName());
+      return true;
+    }
+    erase(i);                     // size changed: re-admit from scratch
+  }
+
+  const size_t cost = m_unit == CapacityUnit::BYTES ? bytes : 1;
+  if (cost > m_capProb + m_capProt) {
+    ++m_stats.rejections;
+    return false;
   }
 
-  m_probList.push_front(name);    // new → MRU probation
-  m_store.emplace(name,
-                  std::make_pair(data, m_probList.begin()));
-  ensureCaps();
+  while (usedTotal() + cost > m_capProb + m_capProt)
+    evictOne();                   // make room first
+
+  Index i = allocNode();
+  m_slab[i].data   = data;
+  m_slab[i].digest = digest;
+  m_slab[i].bytes  = bytes;
+  pushFront(Segment::PROBATION, i);   // new → MRU probation
+  indexInsert(i);
+  ++m_stats.admissions;
   return true;
 }
 
+nfd::fw::CacheStats
+SlruCache::getStats() const
+{
+  nfd::fw::CacheStats stats = m_stats;
+  stats.bytes = m_prob.bytes + m_prot.bytes;
+  return stats;
+}
+
 SlruCache::DataPtr
-SlruCache::fetch(const Name& name)
+SlruCache::fetch(NameDigest digest)
 {
-  auto it = m_store.find(name);
-  if (it == m_store.end())
+  Index i = lookup(digest);
+  if (i == NIL)
     return nullptr;
 
-  auto listIt = it->second.second;
-
-  // Are we still in probation?
-  if (std::find(m_probList.begin(), m_probList.end(), name)
-        != m_probList.end()) {
-    promoteToProtected(name, listIt);
+  if (m_slab[i].segment == Segment::PROBATION) {   // O(1) segment check
+    promoteToProtected(i);
   }
   else {                                     // already in protected
-    m_protList.erase(listIt);
-    m_protList.push_front(name);             // move to MRU
-    it->second.second = m_protList.begin();
+    unlink(i);
+    pushFront(Segment::PROTECTED, i);        // move to MRU
   }
 
-  ++g_cacheStats.hits;                       // record hit
-  NFD_LOG_INFO("SLRU-HIT   " << name);
-  return it->second.first;
+  ++m_stats.hits;                            // record hit
+  NFD_LOG_INFO("SLRU-HIT   " << m_slab[i].data->getName());
+  return m_slab[i].data;
 }
 
+std::pair<NameDigest, SlruCache::DataPtr>
+SlruCache::popVictim()
+{
+  Index victim = m_prob.tail != NIL ? m_prob.tail : m_prot.tail;
+  if (victim == NIL)
+    return {0, nullptr};
+
+  std::pair<NameDigest, DataPtr> entry{m_slab[victim].digest, m_slab[victim].data};
+  erase(victim);
+  return entry;
+}
@@ -1,11 +1,19 @@
 #pragma once
-#include <list>
-#include <unordered_map>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <utility>
+#include <vector>
 #include <ndn-cxx/name.hpp>
 #include <ndn-cxx/data.hpp>
+#include "cache-stats.hpp"
+#include "name-digest.hpp"
 
 /** Simple two-segment LRU (SLRU) with fixed segment sizes.
+ *
+ *  Segment sizes are counted either in entries or in bytes of Data wire
+ *  encoding (CapacityUnit::BYTES); in byte mode an insert keeps evicting
+ *  LRU victims until the new object fits.
  *
  *  ─ New insertions start in the probation segment.
  *  ─ A hit in probation promotes the entry to the protected segment.
@@ -13,39 +21,124 @@
  *  ─ Eviction policy:
  *        • if the cache is full, evict LRU of probation;
  *        • if probation becomes empty, evict LRU of protected.
+ *    (repeated until the new entry fits)
+ *
+ *  Storage layout: every entry lives in an intrusive doubly-linked node
+ *  taken from a slab that is sized once from the total capacity.  Each node
+ *  records the segment it is in, so hits, promotions and evictions are O(1)
+ *  and never touch the heap.  Lookup goes through an open-addressing index
+ *  (linear probing, backward-shift deletion) that is also preallocated.
+ *  In byte mode the entry count is not known up front, so slab and index
+ *  grow geometrically while the cache first fills, then stay put.
+ *  Entries are keyed by the 64-bit NameDigest; the Name is not copied into
+ *  the node, it is read back from the Data when needed.
  */
 class SlruCache
 {
 public:
   using DataPtr = std::shared_ptr<const ndn::Data>;
 
-  /// @param probationCap  #entries in probation segment
-  /// @param protectedCap  #entries in protected segment
-  explicit SlruCache(size_t probationCap = 50, size_t protectedCap = 50);
+  enum class CapacityUnit : uint8_t { ENTRIES, BYTES };
+
+  /// @param probationCap  capacity of probation segment
+  /// @param protectedCap  capacity of protected segment
+  /// @param unit          whether capacities count entries or wire bytes
+  explicit SlruCache(size_t probationCap = 50, size_t protectedCap = 50,
+                     CapacityUnit unit = CapacityUnit::ENTRIES);
 
-  bool      contains(const ndn::Name& name) const;
-  bool      insert  (const ndn::Name& name, const DataPtr& data);
+  bool      contains(NameDigest digest) const;
+  /// @return false if @p data alone exceeds the total capacity
+  bool      insert  (NameDigest digest, const DataPtr& data);
   bool      isFull() const;
   ndn::Name selectVictim() const;
 
+  /// Capacity units @p data would occupy (1, or its wire size in byte mode)
+  size_t costOf(const ndn::Data& data) const;
+
+  /// Collect, in eviction order, the digests of the entries an insert of
+  /// @p cost units would displace.
+  /// @return false if an object of @p cost can never fit
+  bool selectVictims(size_t cost, std::vector<NameDigest>& victims) const;
+
   /// Lookup; returns nullptr on miss
-  DataPtr fetch(const ndn::Name& name);
+  DataPtr fetch(NameDigest digest);
+
+  /// Detach and return the entry that would be evicted next (data is
+  /// nullptr if empty).  Not counted as an eviction: the caller decides
+  /// its fate.
+  std::pair<NameDigest, DataPtr> popVictim();
+
+  size_t size() const { return m_prob.size + m_prot.size; }
+  size_t getCapacity() const { return m_capProb + m_capProt; }
+  CapacityUnit getCapacityUnit() const { return m_unit; }
+
+  /// Hits, admissions, rejections (too large) and evictions of this cache;
+  /// bytes is the current resident size
+  nfd::fw::CacheStats getStats() const;
+
+  size_t getProbationSize()  const { return m_prob.size;  }
+  size_t getProtectedSize()  const { return m_prot.size;  }
+  size_t getProbationBytes() const { return m_prob.bytes; }
+  size_t getProtectedBytes() const { return m_prot.bytes; }
 
 private:
   // ─ helpers ------------------------------------------------------------
-  using List = std::list<ndn::Name>;          // MRU at front
-  using Map  = std::unordered_map<ndn::Name,
-                                  std::pair<DataPtr, List::iterator>>;
+  using Index = uint32_t;
+  static constexpr Index NIL = std::numeric_limits<Index>::max();
+
+  enum class Segment : uint8_t { FREE, PROBATION, PROTECTED };
 
-  void promoteToProtected(const ndn::Name& name, List::iterator lit);
-  void ensureCaps();                          // fix any overflow
+  struct Node
+  {
+    DataPtr     data;
+    NameDigest  digest  = 0;
+    size_t      bytes   = 0;                 ///< wire size of data
+    Index       prev    = NIL;
+    Index       next    = NIL;               ///< also links the free list
+    Segment     segment = Segment::FREE;
+  };
+
+  struct List                                 ///< MRU at head
+  {
+    Index  head  = NIL;
+    Index  tail  = NIL;
+    size_t size  = 0;                         ///< #entries
+    size_t bytes = 0;                         ///< sum of entry wire sizes
+  };
+
+  List& listOf(Segment seg) { return seg == Segment::PROTECTED ? m_prot : m_prob; }
+
+  size_t used(const List& l) const { return m_unit == CapacityUnit::BYTES ? l.bytes : l.size; }
+  size_t usedTotal() const { return used(m_prob) + used(m_prot); }
+  size_t costOf(Index i) const { return m_unit == CapacityUnit::BYTES ? m_slab[i].bytes : 1; }
+
+  void  pushFront(Segment seg, Index i);
+  void  unlink(Index i);
+  Index allocNode();
+  void  freeNode(Index i);
+  void  grow();                               ///< byte mode only
+
+  Index findSlot(NameDigest digest) const;    ///< slot in m_buckets or NIL
+  Index lookup(NameDigest digest) const;      ///< node or NIL
+  void  indexInsert(Index node);
+  void  indexErase(Index node);
+
+  void promoteToProtected(Index i);
+  void evictOne();
+  void erase(Index i);
 
   // ─ members ------------------------------------------------------------
-  size_t m_capProb;
-  size_t m_capProt;
+  size_t       m_capProb;
+  size_t       m_capProt;
+  CapacityUnit m_unit;
 
-  List m_probList;        ///< probation   (MRU front)
-  List m_protList;        ///< protected   (MRU front)
-  Map  m_store;           ///< name → (data, iterator into its list)
-};
+  List m_prob;                  ///< probation   (MRU head)
+  List m_prot;                  ///< protected   (MRU head)
 
+  std::vector<Node>  m_slab;    ///< capProb + capProt nodes in entry mode
+  Index              m_free = NIL;
+  std::vector<Index> m_buckets; ///< open-addressing index → node, pow2 sized
+  std::size_t        m_mask = 0;
+
+  nfd::fw::CacheStats m_stats;
+};
@@ -0,0 +1,149 @@
+// space-saving.cpp — bounded top-K access counting for the fog report
+
+#include "space-saving.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+SpaceSaving::SpaceSaving(size_t capacity)
+  : m_slab(std::max<size_t>(capacity, 1))
+{
+  assert(m_slab.size() < NIL);
+  m_heap.reserve(m_slab.size());
+  m_index.reserve(m_slab.size());
+  m_dirty.reserve(m_slab.size());
+}
+
+// ────────────────────────────────────────────────────────────────
+// min-heap on count (heapPos kept in the slot for O(log n) updates)
+void
+SpaceSaving::place(size_t pos, Index slot)
+{
+  m_heap[pos] = slot;
+  m_slab[slot].heapPos = static_cast<Index>(pos);
+}
+
+void
+SpaceSaving::siftUp(size_t pos)
+{
+  const Index slot = m_heap[pos];
+  const uint64_t c = m_slab[slot].count;
+  while (pos > 0) {
+    size_t parent = (pos - 1) / 2;
+    if (m_slab[m_heap[parent]].count <= c)
+      break;
+    place(pos, m_heap[parent]);
+    pos = parent;
+  }
+  place(pos, slot);
+}
+
+void
+SpaceSaving::siftDown(size_t pos)
+{
+  const Index slot = m_heap[pos];
+  const uint64_t c = m_slab[slot].count;
+  const size_t n = m_heap.size();
+  for (;;) {
+    size_t child = 2 * pos + 1;
+    if (child >= n)
+      break;
+    if (child + 1 < n && m_slab[m_heap[child + 1]].count < m_slab[m_heap[child]].count)
+      ++child;
+    if (c <= m_slab[m_heap[child]].count)
+      break;
+    place(pos, m_heap[child]);
+    pos = child;
+  }
+  place(pos, slot);
+}
+
+void
+SpaceSaving::markDirty(Index slot)
+{
+  if (!m_slab[slot].dirty) {
+    m_slab[slot].dirty = true;
+    m_dirty.push_back(slot);
+  }
+}
+
+// ────────────────────────────────────────────────────────────────
+// counting
+void
+SpaceSaving::record(NameDigest digest, const ndn::Name& name)
+{
+  auto it = m_index.find(digest);
+  if (it != m_index.end()) {
+    Slot& s = m_slab[it->second];
+    ++s.count;
+    markDirty(it->second);
+    siftDown(s.heapPos);
+    return;
+  }
+
+  if (m_heap.size() < m_slab.size()) {           // free slot
+    Index slot = static_cast<Index>(m_heap.size());
+    Slot& s  = m_slab[slot];
+    s.name   = name;
+    s.digest = digest;
+    s.count  = 1;
+    s.error  = 0;
+    m_heap.push_back(slot);
+    s.heapPos = static_cast<Index>(m_heap.size() - 1);
+    siftUp(s.heapPos);
+    m_index.emplace(digest, slot);
+    markDirty(slot);
+    return;
+  }
+
+  // full: take over the minimum, keeping its observed count in "other"
+  const Index slot = m_heap.front();
+  Slot& s = m_slab[slot];
+  m_other += observed(s);
+  // re-key the victim's index node in place: no allocation per takeover
+  auto node = m_index.extract(s.digest);
+  node.key() = digest;
+  m_index.insert(std::move(node));
+
+  s.name   = name;
+  s.digest = digest;
+  s.error  = s.count;
+  s.count += 1;
+  markDirty(slot);
+  siftDown(0);
+}
+
+uint64_t
+SpaceSaving::drain(size_t k, std::vector<Item>& top)
+{
+  top.clear();
+
+  auto byObserved = [this] (Index a, Index b) { return observed(m_slab[a]) > observed(m_slab[b]); };
+  const size_t nTop = std::min(k, m_dirty.size());
+  if (nTop < m_dirty.size())
+    std::nth_element(m_dirty.begin(), m_dirty.begin() + nTop, m_dirty.end(), byObserved);
+  std::sort(m_dirty.begin(), m_dirty.begin() + nTop, byObserved);
+
+  uint64_t other = m_other;
+  for (size_t i = 0; i < m_dirty.size(); ++i) {
+    Slot& s = m_slab[m_dirty[i]];
+    const uint64_t n = observed(s);
+    if (i < nTop && n > 0)
+      top.push_back({&s.name, n});
+    else
+      other += n;
+  }
+
+  // new window: only dirty slots hold non-zero counts, and an all-zero
+  // heap is trivially ordered
+  for (Index slot : m_dirty) {
+    m_slab[slot].count = 0;
+    m_slab[slot].error = 0;
+    m_slab[slot].dirty = false;
+  }
+  m_dirty.clear();
+  m_other = 0;
+
+  return other;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+#include <ndn-cxx/name.hpp>
+#include "name-digest.hpp"
+
+/** Fixed-capacity heavy-hitter tracker (Space-Saving, Metwally et al.).
+ *
+ *  ─ At most `capacity` names are monitored.  A name that is not monitored
+ *    takes over the slot with the smallest count c; it starts at c + 1 with
+ *    error c, so its count never under-estimates.
+ *  ─ Counting is per report window: drain() hands out the window's top-K
+ *    names by observed count (count − error) plus one aggregate for all
+ *    the rest, then zeroes every counter.  Names stay monitored across
+ *    windows while they keep getting hits; idle ones are the first to be
+ *    displaced, since their count is back to 0.
+ *  ─ Nothing is lost: observed counts of displaced or non-top-K names end
+ *    up in the aggregate, so deltas + other == accesses in the window.
+ *
+ *  Memory is fixed by `capacity` (slab, min-heap and index are sized once),
+ *  whatever the catalogue size.
+ */
+class SpaceSaving
+{
+public:
+  struct Item
+  {
+    const ndn::Name* name;     ///< valid until the next record()
+    uint64_t         count;    ///< observed accesses in the window
+  };
+
+  explicit SpaceSaving(size_t capacity);
+
+  /// Count one access; @p name is copied only when a slot is (re)assigned
+  void     record(NameDigest digest, const ndn::Name& name);
+
+  /// Close the window: the (at most) @p k largest counts go to @p top in
+  /// descending order, everything else is summed into the return value.
+  uint64_t drain(size_t k, std::vector<Item>& top);
+
+  size_t   size()     const { return m_heap.size(); }
+  size_t   capacity() const { return m_slab.size(); }
+
+private:
+  using Index = uint32_t;
+  static constexpr Index NIL = std::numeric_limits<Index>::max();
+
+  struct Slot
+  {
+    ndn::Name  name;
+    NameDigest digest   = 0;
+    uint64_t   count    = 0;
+    uint64_t   error    = 0;
+    Index      heapPos  = NIL;
+    bool       dirty    = false;   ///< listed in m_dirty this window
+  };
+
+  uint64_t observed(const Slot& s) const { return s.count - s.error; }
+
+  void siftUp(size_t pos);
+  void siftDown(size_t pos);
+  void place(size_t pos, Index slot);
+  void markDirty(Index slot);
+
+private:
+  std::vector<Slot>                      m_slab;
+  std::vector<Index>                     m_heap;    ///< min-heap on count
+  std::unordered_map<NameDigest, Index>  m_index;   ///< reserved to capacity
+  std::vector<Index>                     m_dirty;   ///< slots counted this window
+  uint64_t                               m_other = 0;   ///< observed counts of displaced names
+};
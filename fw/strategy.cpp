@@ -233,6 +233,24 @@ Strategy::afterNewNextHop(const fib::NextHop& nextHop, const shared_ptr<pit::Ent
                 << " nexthop=" << nextHop.getFace().getId());
 }
 
+void
+Strategy::afterReceiveUnsolicitedData(const Data& data, const FaceEndpoint& ingress)
+{
+  NFD_LOG_DEBUG("afterReceiveUnsolicitedData in=" << ingress << " data=" << data.getName());
+}
+
+bool
+Strategy::beforePitInsert(const Interest&, const FaceEndpoint&)
+{
+  return false;
+}
+
+bool
+Strategy::beforeCsInsert(const Data&, const FaceEndpoint&)
+{
+  return true;
+}
+
 pit::OutRecord*
 Strategy::sendInterest(const Interest& interest, Face& egress, const shared_ptr<pit::Entry>& pitEntry)
 {
@@ -276,6 +294,20 @@ Strategy::sendData(const Data& data, Face& egress, const shared_ptr<pit::Entry>&
   return true;
 }
 
+bool
+Strategy::sendDataWithoutPit(const Data& data, const Interest& interest, Face& egress)
+{
+  BOOST_ASSERT(interest.matchesData(data));
+
+  auto pitToken = interest.getTag<lp::PitToken>();
+  if (pitToken != nullptr) {
+    Data data2 = data; // make a copy, the cached Data is shared
+    data2.setTag(pitToken);
+    return m_forwarder.onOutgoingData(data2, egress);
+  }
+  return m_forwarder.onOutgoingData(data, egress);
+}
+
 void
 Strategy::sendDataToAll(const Data& data, const shared_ptr<pit::Entry>& pitEntry, const Face& inFace)
 {
@@ -275,6 +275,47 @@ public: // triggers
   virtual void
   afterNewNextHop(const fib::NextHop& nextHop, const shared_ptr<pit::Entry>& pitEntry);
 
+  /**
+   * \brief Trigger after an unsolicited Data is received.
+   *
+   * This trigger is invoked when an incoming Data matches no PIT entry, after the
+   * unsolicited Data policy has decided whether to admit it into the ContentStore.
+   * The effective strategy is the one managing the Data name's namespace.
+   * It lets a strategy consume Data pushed to it by neighbours (e.g. proactive cache fill).
+   *
+   * In the base class, this method does nothing.
+   */
+  virtual void
+  afterReceiveUnsolicitedData(const Data& data, const FaceEndpoint& ingress);
+
+  /**
+   * \brief Trigger before PIT insertion, right after the Dead Nonce List check.
+   *
+   * Lets a strategy that keeps its own cache answer an Interest without the
+   * forwarder creating a PIT entry, looking up the ContentStore, inserting an
+   * in-record and arming the expiry timer, all of which a hit would tear down
+   * again.  The effective strategy is the one managing the Interest name's
+   * namespace.  To answer, send the Data with sendDataWithoutPit() and return true;
+   * the forwarder then stops processing the Interest.
+   *
+   * In the base class, this method returns false.
+   */
+  virtual bool
+  beforePitInsert(const Interest& interest, const FaceEndpoint& ingress);
+
+  /**
+   * \brief Trigger before a Data that matched the PIT is inserted into the ContentStore.
+   *
+   * Lets a strategy apply its own admission decision to the forwarder's
+   * ContentStore.  The effective strategy is the one managing the first matched
+   * PIT entry's namespace.  Return false to keep the Data out of the ContentStore;
+   * the Data still satisfies the PIT entries.
+   *
+   * In the base class, this method returns true.
+   */
+  virtual bool
+  beforeCsInsert(const Data& data, const FaceEndpoint& ingress);
+
 protected: // actions
   /**
    * \brief Send an Interest packet.
@@ -296,6 +337,17 @@ protected: // actions
   NFD_VIRTUAL_WITH_TESTS bool
   sendData(const Data& data, Face& egress, const shared_ptr<pit::Entry>& pitEntry);
 
+  /**
+   * \brief Send a Data packet answering \p interest, which has no PIT entry.
+   * \param data the Data packet, must satisfy \p interest
+   * \param interest the Interest being answered (its PIT token, if any, is echoed)
+   * \param egress face through which to send out the Data
+   * \return Whether the Data was sent (true) or dropped (false)
+   * \sa beforePitInsert
+   */
+  bool
+  sendDataWithoutPit(const Data& data, const Interest& interest, Face& egress);
+
   /**
    * \brief Send a Data packet to all matched and qualified faces.
    *
@@ -382,6 +434,23 @@ protected: // accessors
     return m_forwarder.m_faceTable;
   }
 
+  /** \brief Read-only FIB, for strategies that route their own control traffic.
+   */
+  const Fib&
+  getFib() const
+  {
+    return m_forwarder.m_fib;
+  }
+
+  /** \brief Content Store, for strategies that admit Data arriving outside a
+   *         PIT match (e.g. pushed by a neighbour).
+   */
+  Cs&
+  getCs()
+  {
+    return m_forwarder.m_cs;
+  }
+
 protected: // instance name
   struct ParsedInstanceName
   {
@@ -0,0 +1,88 @@
+// theta-table.cpp — hashed name trie for per-prefix θ_cache
+
+#include "theta-table.hpp"
+
+#include <vector>
+
+void
+ThetaTable::set(const ndn::Name& prefix, double theta, uint64_t deadline)
+{
+  NameDigest key = ROOT_PREFIX_DIGEST;
+  Node* node = &m_nodes[key];
+  for (const auto& comp : prefix) {
+    key = extendPrefixDigest(key, comp);
+    auto [it, isNew] = m_nodes.try_emplace(key);
+    if (isNew)
+      ++node->children;
+    node = &it->second;                          // references survive rehashing
+  }
+
+  if (!node->hasTheta)
+    ++m_size;
+  node->theta    = theta;
+  node->hasTheta = true;
+  node->deadline = deadline;
+}
+
+bool
+ThetaTable::erase(const ndn::Name& prefix)
+{
+  return eraseIf(prefix, NEVER);
+}
+
+bool
+ThetaTable::expire(const ndn::Name& prefix, uint64_t now)
+{
+  return now != NEVER && eraseIf(prefix, now);
+}
+
+/// erase @p prefix if its deadline is ≤ @p now (NEVER: unconditionally)
+bool
+ThetaTable::eraseIf(const ndn::Name& prefix, uint64_t now)
+{
+  std::vector<NameDigest> path;
+  path.reserve(prefix.size() + 1);
+  path.push_back(ROOT_PREFIX_DIGEST);
+  for (const auto& comp : prefix)
+    path.push_back(extendPrefixDigest(path.back(), comp));
+
+  auto it = m_nodes.find(path.back());
+  if (it == m_nodes.end() || !it->second.hasTheta || it->second.deadline > now)
+    return false;
+  it->second.hasTheta = false;
+  --m_size;
+
+  // prune the now-empty tail of the path
+  for (size_t i = path.size(); i-- > 0; ) {
+    it = m_nodes.find(path[i]);
+    if (it->second.hasTheta || it->second.children > 0)
+      break;
+    m_nodes.erase(it);
+    if (i > 0)
+      --m_nodes.find(path[i - 1])->second.children;
+  }
+  return true;
+}
+
+double
+ThetaTable::lookup(const ndn::Name& name, double fallback) const
+{
+  if (m_size == 0)
+    return fallback;
+
+  auto it = m_nodes.find(ROOT_PREFIX_DIGEST);
+  double theta = it->second.hasTheta ? it->second.theta : fallback;
+
+  NameDigest key = ROOT_PREFIX_DIGEST;
+  for (const auto& comp : name) {
+    if (it->second.children == 0)
+      break;
+    key = extendPrefixDigest(key, comp);
+    it = m_nodes.find(key);
+    if (it == m_nodes.end())
+      break;
+    if (it->second.hasTheta)
+      theta = it->second.theta;
+  }
+  return theta;
+}
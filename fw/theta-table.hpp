@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <ndn-cxx/name.hpp>
+#include "name-digest.hpp"
+
+/** Prefix-granular θ_cache store with longest-prefix-match lookup.
+ *
+ *  ─ The fog controller instructs θ per prefix (/video/x covers every
+ *    /video/x/seg=N), so memory grows with the instructed prefixes, not with
+ *    the contents under them.
+ *  ─ It is a hashed trie: a node is keyed by the chained digest of its
+ *    prefix (extendPrefixDigest), so walking a Name needs one hash pass over
+ *    its bytes and one probe per component.  Every ancestor of an instructed
+ *    prefix has a node, so the walk stops at the first missing one and
+ *    lookup is O(name length).
+ *  ─ Nodes carry a child count and are pruned bottom-up once they hold
+ *    neither θ nor children.
+ *  ─ An entry may carry a deadline (in the caller's ticks); expire() drops it
+ *    only if that deadline has passed, so a timer for an entry that was
+ *    re-instructed since is harmless.
+ */
+class ThetaTable
+{
+public:
+  static constexpr uint64_t NEVER = std::numeric_limits<uint64_t>::max();
+
+  /// Set θ for @p prefix (and so for every name below it) until @p deadline
+  void     set(const ndn::Name& prefix, double theta, uint64_t deadline = NEVER);
+  /// Drop the θ of exactly @p prefix; @return false if it had none
+  bool     erase(const ndn::Name& prefix);
+  /// Drop the θ of @p prefix if its deadline is at or before @p now
+  bool     expire(const ndn::Name& prefix, uint64_t now);
+  void     clear() { m_nodes.clear(); m_size = 0; }
+
+  /// θ of the longest instructed prefix of @p name, else @p fallback
+  double   lookup(const ndn::Name& name, double fallback) const;
+
+  size_t   size()  const { return m_size; }    ///< instructed prefixes
+  bool     empty() const { return m_size == 0; }
+
+private:
+  struct Node
+  {
+    double   theta    = 0.0;
+    bool     hasTheta = false;
+    uint32_t children = 0;
+    uint64_t deadline = NEVER;
+  };
+
+  bool     eraseIf(const ndn::Name& prefix, uint64_t now);
+
+  std::unordered_map<NameDigest, Node> m_nodes;   ///< key: chained prefix digest
+  size_t                               m_size = 0;
+};
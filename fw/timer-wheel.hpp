@@ -0,0 +1,76 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/** Hashed timer wheel over integer ticks.
+ *
+ *  ─ schedule() drops an item into slot `deadline % slots`: O(1), no heap.
+ *  ─ advance(now) visits only the slots of the ticks elapsed since the last
+ *    call (at most one revolution) and fires the items that are due; items
+ *    further than one revolution out stay in their slot for a later lap.
+ *  ─ Cancellation is left to the owner: fire callbacks should check that the
+ *    item is still current (lazy deletion), which keeps re-arming O(1).
+ */
+template<typename T>
+class TimerWheel
+{
+public:
+  explicit
+  TimerWheel(size_t slots)
+    : m_slots(std::max<size_t>(slots, 1))
+  {
+  }
+
+  void
+  schedule(uint64_t deadline, T item)
+  {
+    deadline = std::max(deadline, m_next);       // overdue: fire on the next advance
+    m_slots[deadline % m_slots.size()].emplace_back(deadline, std::move(item));
+    ++m_size;
+  }
+
+  /// Fire every item due at or before tick @p now, oldest slot first
+  template<typename OnExpire>
+  void
+  advance(uint64_t now, OnExpire&& onExpire)
+  {
+    if (now < m_next)
+      return;
+
+    const uint64_t steps = std::min<uint64_t>(now - m_next + 1, m_slots.size());
+    for (uint64_t i = 0; i < steps; ++i) {
+      auto& slot = m_slots[(m_next + i) % m_slots.size()];
+      for (size_t j = 0; j < slot.size(); ) {
+        if (slot[j].first > now) {
+          ++j;
+          continue;
+        }
+        T item = std::move(slot[j].second);
+        slot[j] = std::move(slot.back());
+        slot.pop_back();
+        --m_size;
+        onExpire(item);
+      }
+    }
+    m_next = now + 1;
+  }
+
+  void
+  clear()
+  {
+    for (auto& slot : m_slots)
+      std::vector<std::pair<uint64_t, T>>().swap(slot);
+    m_size = 0;
+  }
+
+  size_t size()  const { return m_size; }
+  bool   empty() const { return m_size == 0; }
+
+private:
+  std::vector<std::vector<std::pair<uint64_t, T>>> m_slots;
+  uint64_t                                         m_next = 0;   ///< first tick not yet advanced
+  size_t                                           m_size = 0;
+};
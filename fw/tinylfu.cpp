@@ -0,0 +1,179 @@
+// tinylfu.cpp — W-TinyLFU admission (window LRU + doorkeeper + aging CMS)
+
+#include "tinylfu.hpp"
+#include "NFD/daemon/common/logger.hpp"
+
+#include <algorithm>
+
+NFD_LOG_INIT(tinylfu);
+
+namespace {
+
+constexpr unsigned DOORKEEPER_HASHES = 3;
+constexpr unsigned DOORKEEPER_BITS_PER_ENTRY = 8;   // ~3 % false positives
+
+/** splitmix64 finaliser: decorrelates bit selection from SLRU/CMS indexing */
+inline uint64_t
+remix(uint64_t x)
+{
+  x ^= x >> 30; x *= 0xBF58476D1CE4E5B9ull;
+  x ^= x >> 27; x *= 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
+} // unnamed namespace
+
+// ────────────────────────────────────────────────────────────────
+// doorkeeper
+WTinyLfu::Doorkeeper::Doorkeeper(uint64_t expectedInsertions)
+{
+  uint64_t nBits = 64;
+  while (nBits < expectedInsertions * DOORKEEPER_BITS_PER_ENTRY)
+    nBits <<= 1;
+  m_bits.assign(nBits / 64, 0);
+  m_mask = nBits - 1;
+}
+
+bool
+WTinyLfu::Doorkeeper::testAndSet(NameDigest digest)
+{
+  const uint64_t h  = remix(digest);
+  const uint64_t h2 = (h >> 32) | 1;
+  bool present = true;
+  for (unsigned i = 0; i < DOORKEEPER_HASHES; ++i) {
+    uint64_t bit  = (h + i * h2) & m_mask;
+    uint64_t mask = uint64_t(1) << (bit & 63);
+    present &= (m_bits[bit >> 6] & mask) != 0;
+    m_bits[bit >> 6] |= mask;
+  }
+  return present;
+}
+
+bool
+WTinyLfu::Doorkeeper::contains(NameDigest digest) const
+{
+  const uint64_t h  = remix(digest);
+  const uint64_t h2 = (h >> 32) | 1;
+  for (unsigned i = 0; i < DOORKEEPER_HASHES; ++i) {
+    uint64_t bit = (h + i * h2) & m_mask;
+    if ((m_bits[bit >> 6] & (uint64_t(1) << (bit & 63))) == 0)
+      return false;
+  }
+  return true;
+}
+
+void
+WTinyLfu::Doorkeeper::clear()
+{
+  std::fill(m_bits.begin(), m_bits.end(), 0);
+}
+
+// ────────────────────────────────────────────────────────────────
+// W-TinyLFU
+WTinyLfu::WTinyLfu(FrequencySketch& sketch, SlruCache& main,
+                   size_t windowCap, uint64_t sampleSize)
+  : m_sketch(sketch)
+  , m_main(main)
+  , m_window(std::max<size_t>(windowCap, 1), 0, main.getCapacityUnit())
+  , m_doorkeeper(sampleSize)
+  , m_sampleSize(std::max<uint64_t>(sampleSize, 1))
+{
+}
+
+void
+WTinyLfu::recordAccess(NameDigest digest)
+{
+  if (m_doorkeeper.testAndSet(digest))
+    m_sketch.increment(digest);         // seen before in this sample
+
+  if (++m_samples >= m_sampleSize) {    // aging: halve & forget one-hit wonders
+    m_sketch.halve();
+    m_doorkeeper.clear();
+    m_samples = 0;
+    NFD_LOG_DEBUG("TINYLFU-RESET");
+  }
+}
+
+uint64_t
+WTinyLfu::frequency(NameDigest digest) const
+{
+  uint64_t f = m_sketch.estimate(digest);
+  if (m_doorkeeper.contains(digest))
+    ++f;
+  return f;
+}
+
+bool
+WTinyLfu::contains(NameDigest digest) const
+{
+  return m_window.contains(digest) || m_main.contains(digest);
+}
+
+WTinyLfu::DataPtr
+WTinyLfu::fetch(NameDigest digest)
+{
+  if (auto data = m_window.fetch(digest))
+    return data;
+  return m_main.fetch(digest);
+}
+
+bool
+WTinyLfu::insert(NameDigest digest, const DataPtr& data)
+{
+  if (m_main.contains(digest))
+    return m_main.insert(digest, data);   // refresh in place
+  if (m_window.contains(digest))
+    return m_window.insert(digest, data); // likewise, no victims to spill
+
+  const size_t cost = m_window.costOf(*data);
+  m_victims.clear();
+  if (!m_window.selectVictims(cost, m_victims))
+    return false;
+
+  // hand every window victim to the main-cache duel before making room
+  for (size_t n = m_victims.size(); n > 0; --n) {
+    auto victim = m_window.popVictim();
+    admitToMain(victim.first, victim.second);
+  }
+
+  return m_window.insert(digest, data);
+}
+
+nfd::fw::CacheStats
+WTinyLfu::getStats() const
+{
+  const nfd::fw::CacheStats window = m_window.getStats();
+  const nfd::fw::CacheStats main   = m_main.getStats();
+
+  nfd::fw::CacheStats stats;
+  stats.hits       = window.hits + main.hits;
+  stats.admissions = window.admissions;
+  stats.rejections = window.rejections;
+  stats.evictions  = m_dropped + main.evictions;
+  stats.bytes      = window.bytes + main.bytes;
+  return stats;
+}
+
+void
+WTinyLfu::admitToMain(NameDigest digest, const DataPtr& candidate)
+{
+  m_victims.clear();
+  if (!m_main.selectVictims(m_main.costOf(*candidate), m_victims)) {
+    ++m_dropped;
+    return;
+  }
+
+  if (!m_victims.empty()) {
+    uint64_t victimFreq = 0;
+    for (NameDigest victim : m_victims)
+      victimFreq += frequency(victim);
+
+    if (frequency(digest) <= victimFreq) {  // candidate loses: drop it
+      ++m_dropped;
+      NFD_LOG_INFO("TINYLFU-REJECT " << candidate->getName());
+      return;
+    }
+  }
+
+  m_main.insert(digest, candidate);         // evicts the losers (counted in slru.cpp)
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <ndn-cxx/name.hpp>
+#include "cms.hpp"
+#include "slru.hpp"
+
+/** W-TinyLFU admission in front of an SLRU main cache.
+ *
+ *  ─ Every access is recorded: the first sighting of a name within a sample
+ *    period only sets its doorkeeper bits, later ones bump the sketch.
+ *  ─ After `sampleSize` accesses the sketch is halved and the doorkeeper
+ *    cleared, so frequencies track recent popularity.
+ *  ─ New Data always enters a small window LRU.  Whatever the window pushes
+ *    out duels with the main-cache victim(s) it would displace; the
+ *    candidate is admitted only if it is strictly more frequent.
+ *
+ *  The sketch and main cache are owned by the caller (CustomStrategy).
+ */
+class WTinyLfu
+{
+public:
+  using DataPtr = SlruCache::DataPtr;
+
+  /// @param windowCap   window LRU capacity, same unit as @p main
+  /// @param sampleSize  accesses per aging period
+  WTinyLfu(FrequencySketch& sketch, SlruCache& main,
+           size_t windowCap, uint64_t sampleSize);
+
+  /// Record one access (call on every Interest, hit or miss)
+  void     recordAccess(NameDigest digest);
+  /// Doorkeeper-adjusted frequency estimate
+  uint64_t frequency(NameDigest digest) const;
+
+  bool     contains(NameDigest digest) const;
+  DataPtr  fetch(NameDigest digest);
+
+  /// Place @p data in the window; spill window victims through the duel.
+  /// @return false if @p data can never fit
+  bool     insert(NameDigest digest, const DataPtr& data);
+
+  /// Counters of window + main cache as one: admissions are entries into
+  /// the window, evictions count duel losers and main-cache evictions
+  nfd::fw::CacheStats getStats() const;
+
+private:
+  /** Bloom filter remembering names seen once in the current sample. */
+  class Doorkeeper
+  {
+  public:
+    explicit Doorkeeper(uint64_t expectedInsertions);
+    bool testAndSet(NameDigest digest);             ///< true if already present
+    bool contains(NameDigest digest) const;
+    void clear();
+
+  private:
+    std::vector<uint64_t> m_bits;
+    std::size_t           m_mask;                   ///< #bits - 1 (pow2)
+  };
+
+  void admitToMain(NameDigest digest, const DataPtr& candidate);
+
+private:
+  FrequencySketch& m_sketch;
+  SlruCache&      m_main;
+  SlruCache       m_window;           ///< plain LRU (no protected segment)
+  Doorkeeper      m_doorkeeper;
+  uint64_t        m_sampleSize;
+  uint64_t        m_samples = 0;
+  uint64_t        m_dropped = 0;      ///< window victims that lost the duel
+
+  std::vector<NameDigest> m_victims;   ///< scratch for the duel
+};
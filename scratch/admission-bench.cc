@@ -0,0 +1,149 @@
+/* admission-bench.cc --------------------------------------------------------
+ * CustomStrategy admission policies side by side on one cache node:
+ *
+ *   cms      – admission~cms (default): the SLRU admits a Data only if its
+ *              sketch estimate is not below the victims' (admitByFrequency),
+ *              the sketch counting arriving Data
+ *   tinylfu  – admission~tinylfu: W-TinyLFU window, doorkeeper, aging and
+ *              duel (fw/tinylfu.hpp), counting every Interest
+ *
+ * The request stream is the stress-cache-multi2 workload seen by a single
+ * router: Zipf(--zipf) over --catalogue names.  --shift > 0 rotates the
+ * popularity ranks every that many requests (bursty load, new content
+ * becoming hot).  Sizes and aging follow the strategy's defaults
+ * (slru 25 + 25, cms 4 x 2048, aging every 10 x capacity, window 1 %).
+ *
+ * Prints hit ratio and CPU time per request (lookup + admission on miss).
+ *
+ * usage:  ./waf --run "admission-bench --requests=2000000 --shift=100000"
+ * ------------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM/NFD/daemon/fw/tinylfu.hpp"
+
+using namespace ns3;
+
+/* --------------------------------------------------------------------- */
+static NameDigest
+Key (uint64_t i)
+{
+  // splitmix64 finaliser: distinct, well-spread digests for 0, 1, 2, ...
+  i += 0x9e3779b97f4a7c15ull;
+  i = (i ^ (i >> 30)) * 0xbf58476d1ce4e5b9ull;
+  i = (i ^ (i >> 27)) * 0x94d049bb133111ebull;
+  return i ^ (i >> 31);
+}
+
+/* --------------------------------------------------------------------- */
+/* CustomStrategy::admitByFrequency, minus the strategy around it         */
+static bool
+AdmitByFrequency (SlruCache& slru, CountMinSketch& cms, NameDigest digest,
+                  const SlruCache::DataPtr& data, std::vector<NameDigest>& victims)
+{
+  victims.clear ();
+  if (!slru.selectVictims (slru.costOf (*data), victims))
+    return false;
+
+  uint64_t estVictims = 0;
+  for (NameDigest v : victims)
+    estVictims += cms.estimate (v);
+  if (!victims.empty () && estVictims > cms.estimate (digest))
+    return false;
+  return slru.insert (digest, data);
+}
+
+/* --------------------------------------------------------------------- */
+int
+main (int argc, char* argv[])
+{
+  uint32_t catalogue = 10000;
+  double   zipf      = 1.2;
+  uint32_t requests  = 2000000;
+  uint32_t shift     = 0;
+  uint32_t prob      = 25;
+  uint32_t prot      = 25;
+
+  CommandLine cmd;
+  cmd.AddValue ("catalogue", "distinct names", catalogue);
+  cmd.AddValue ("zipf", "Zipf exponent", zipf);
+  cmd.AddValue ("requests", "Interests replayed", requests);
+  cmd.AddValue ("shift", "rotate popularity every n requests (0: never)", shift);
+  cmd.AddValue ("prob", "SLRU probation capacity (entries)", prob);
+  cmd.AddValue ("prot", "SLRU protected capacity (entries)", prot);
+  cmd.Parse (argc, argv);
+
+  // the trace, drawn once so both policies see the same requests
+  std::vector<double> weights (catalogue);
+  for (uint32_t r = 0; r < catalogue; ++r)
+    weights[r] = 1.0 / std::pow (r + 1.0, zipf);
+  std::discrete_distribution<uint32_t> rank (weights.begin (), weights.end ());
+  std::mt19937_64 rng (1);
+  std::vector<NameDigest> trace (requests);
+  for (uint32_t i = 0; i < requests; ++i)
+    {
+      const uint64_t epoch = shift > 0 ? i / shift : 0;
+      trace[i] = Key ((rank (rng) + epoch * 7919) % catalogue);
+    }
+
+  const auto data = std::make_shared<const ndn::Data> (ndn::Name ("/bench"));
+  const size_t capacity = prob + prot;
+  std::vector<NameDigest> victims;
+
+  std::printf ("catalogue %u, zipf %.2f, %u requests, shift %u, slru %u+%u\n",
+               catalogue, zipf, requests, shift, prob, prot);
+  std::printf ("%8s %10s %14s\n", "policy", "hit ratio", "ns/request");
+
+  // admission~cms
+  {
+    SlruCache slru (prob, prot);
+    CountMinSketch cms (4, 2048);
+    cms.setHalvingPeriod (10 * capacity);
+    uint64_t hits = 0;
+    const auto start = std::chrono::steady_clock::now ();
+    for (NameDigest d : trace)
+      {
+        if (slru.fetch (d))
+          {
+            ++hits;
+            continue;
+          }
+        cms.increment (d); // Data arrives for the miss
+        AdmitByFrequency (slru, cms, d, data, victims);
+      }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now () - start;
+    std::printf ("%8s %10.4f %14.1f\n", "cms", static_cast<double> (hits) / requests,
+                 elapsed.count () / requests);
+  }
+
+  // admission~tinylfu
+  {
+    SlruCache slru (prob, prot);
+    CountMinSketch cms (4, 2048);
+    WTinyLfu tinyLfu (cms, slru, capacity / 100, 10 * capacity);
+    uint64_t hits = 0;
+    const auto start = std::chrono::steady_clock::now ();
+    for (NameDigest d : trace)
+      {
+        tinyLfu.recordAccess (d);
+        if (tinyLfu.fetch (d))
+          {
+            ++hits;
+            continue;
+          }
+        tinyLfu.insert (d, data);
+      }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now () - start;
+    std::printf ("%8s %10.4f %14.1f\n", "tinylfu", static_cast<double> (hits) / requests,
+                 elapsed.count () / requests);
+  }
+  return 0;
+}
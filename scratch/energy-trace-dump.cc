@@ -0,0 +1,79 @@
+/* energy-trace-dump.cc ------------------------------------------------------
+ * Convert a binary energy trace (nfd::fw::EnergyTrace, see
+ * NFD/daemon/fw/energy-trace.hpp) to CSV on stdout:
+ *
+ *   time_s,node,interest_rx_j,interest_tx_j,data_rx_j,data_tx_j,cache_insert_j
+ *
+ * Enable the trace in a scenario with
+ *   #include "ns3/ndnSIM/NFD/daemon/fw/energy-trace.hpp"
+ *   nfd::fw::EnergyTrace::InstallAll ("metrics/energy-trace.bin", Seconds (1.0));
+ *
+ * usage:  ./waf --run "energy-trace-dump --file=metrics/energy-trace.bin"
+ * ------------------------------------------------------------------------- */
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+/* --------------------------------------------------------------------- */
+template <typename T>
+static bool
+ReadColumn (std::ifstream& in, std::vector<T>& column, uint32_t rows)
+{
+  column.resize (rows);
+  in.read (reinterpret_cast<char*> (column.data ()), rows * sizeof (T));
+  return static_cast<bool> (in);
+}
+
+/* --------------------------------------------------------------------- */
+int
+main (int argc, char* argv[])
+{
+  std::string file = "metrics/energy-trace.bin";
+
+  CommandLine cmd;
+  cmd.AddValue ("file", "binary energy trace to convert", file);
+  cmd.Parse (argc, argv);
+
+  std::ifstream in (file, std::ios::binary);
+  char header[8];
+  if (!in.read (header, sizeof (header)) || std::string (header, 4) != "NDNE" || header[4] != 1)
+    {
+      std::cerr << file << ": not an energy trace (version 1)\n";
+      return 1;
+    }
+  const uint32_t nOps = static_cast<uint8_t> (header[5]);
+
+  std::cout << "time_s,node,interest_rx_j,interest_tx_j,data_rx_j,data_tx_j,cache_insert_j\n";
+
+  std::vector<uint32_t> time, node;
+  std::vector<std::vector<float>> energy (nOps);
+  uint32_t rows;
+  while (in.read (reinterpret_cast<char*> (&rows), sizeof (rows)))
+    {
+      bool ok = ReadColumn (in, time, rows) && ReadColumn (in, node, rows);
+      for (auto& column : energy)
+        ok = ok && ReadColumn (in, column, rows);
+      if (!ok)
+        {
+          std::cerr << file << ": truncated block\n";
+          return 1;
+        }
+
+      for (uint32_t r = 0; r < rows; ++r)
+        {
+          std::printf ("%.3f,%u", time[r] / 1000.0, node[r]);
+          for (const auto& column : energy)
+            std::printf (",%.9g", column[r]);
+          std::printf ("\n");
+        }
+    }
+  return 0;
+}
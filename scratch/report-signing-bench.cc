@@ -0,0 +1,121 @@
+/* report-signing-bench.cc ---------------------------------------------------
+ * Access-report generation throughput per report-signing~ mode of
+ * CustomStrategy: encode a top-K report (encodeAccessReport), wrap every
+ * segment in a /fog/access-report Data and sign it the way
+ * CustomStrategy::signControl does.
+ *
+ *   none    – type-255 placeholder signature, no crypto
+ *   sha256  – DigestSha256 (the default)
+ *   hmac    – HMAC-SHA256 with the built-in pre-shared key
+ *   ecdsa   – a per-packet public-key signature, what the old function-static
+ *             system KeyChain produced with its default identity; taken from
+ *             an in-memory identity so the host PIB/TPM is left alone
+ *
+ * usage:  ./waf --run "report-signing-bench --entries=100 --reports=2000"
+ * ------------------------------------------------------------------------- */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM/NFD/daemon/fw/access-report.hpp"
+
+#include <ndn-cxx/data.hpp>
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/security/signing-helpers.hpp>
+
+// no "using namespace ns3": ns3::ndn would make ndn:: ambiguous
+
+/* --------------------------------------------------------------------- */
+struct Mode
+{
+  std::string                              label;
+  std::shared_ptr<ndn::security::KeyChain> keyChain;   // unset for none
+  ndn::security::SigningInfo               info;
+};
+
+static void
+Sign (const Mode& mode, ndn::Data& data)
+{
+  if (mode.keyChain)
+    {
+      mode.keyChain->sign (data, mode.info);
+      return;
+    }
+
+  ndn::Signature signature;
+  ndn::SignatureInfo signatureInfo (static_cast<ndn::tlv::SignatureTypeValue> (255));
+  signature.setInfo (signatureInfo);
+  signature.setValue (ndn::makeNonNegativeIntegerBlock (ndn::tlv::SignatureValue, 0));
+  data.setSignature (signature);
+  data.wireEncode ();
+}
+
+/* --------------------------------------------------------------------- */
+int
+main (int argc, char* argv[])
+{
+  uint32_t entries = 100;    // report-topk
+  uint32_t segment = 1200;   // report-segment
+  uint32_t reports = 2000;
+
+  ns3::CommandLine cmd;
+  cmd.AddValue ("entries", "names per report", entries);
+  cmd.AddValue ("segment", "report segment budget in bytes", segment);
+  cmd.AddValue ("reports", "reports generated per mode", reports);
+  cmd.Parse (argc, argv);
+
+  // a Zipf-catalogue-like top-K: siblings under two prefixes
+  std::vector<ndn::Name> names;
+  for (uint32_t i = 0; i < entries; ++i)
+    names.push_back (ndn::Name (i % 4 == 0 ? "/sensor" : "/video").appendSequenceNumber (i * 7));
+  std::vector<SpaceSaving::Item> items;
+  for (uint32_t i = 0; i < entries; ++i)
+    items.push_back ({&names[i], entries - i});
+
+  using ndn::security::KeyChain;
+  std::vector<Mode> modes (4);
+  modes[0].label = "none";
+  modes[1].label = "sha256";
+  modes[1].keyChain = std::make_shared<KeyChain> ("pib-memory:", "tpm-memory:");
+  modes[1].info = ndn::security::signingWithSha256 ();
+  modes[2].label = "hmac";
+  modes[2].keyChain = std::make_shared<KeyChain> ("pib-memory:", "tpm-memory:");
+  modes[2].info.setSigningHmacKey ("Zm9nLWNvbnRyb2wtcGxhbmUta2V5");   // report-hmac-key default
+  modes[3].label = "ecdsa";
+  modes[3].keyChain = std::make_shared<KeyChain> ("pib-memory:", "tpm-memory:");
+  modes[3].info = ndn::security::signingByIdentity (modes[3].keyChain->createIdentity ("/bench/signer"));
+
+  std::printf ("%u entries, %u B segments, %u reports per mode\n", entries, segment, reports);
+  std::printf ("%8s %12s %14s %10s\n", "mode", "reports/s", "us/segment", "segments");
+  for (const Mode& mode : modes)
+    {
+      uint64_t segments = 0;
+      const auto start = std::chrono::steady_clock::now ();
+      for (uint32_t r = 0; r < reports; ++r)
+        {
+          const std::vector<ndn::Block> blocks = encodeAccessReport (items, r, segment);
+          ndn::Name rptName ("/fog/access-report");
+          rptName.appendNumber (1).appendVersion (r);
+          const auto finalBlockId = ndn::name::Component::fromSegment (blocks.size () - 1);
+          for (size_t seg = 0; seg < blocks.size (); ++seg)
+            {
+              ndn::Data data (ndn::Name (rptName).appendSegment (seg));
+              data.setContent (blocks[seg]);
+              data.setFreshnessPeriod (ndn::time::seconds (1));
+              data.setFinalBlock (finalBlockId);
+              Sign (mode, data);
+            }
+          segments += blocks.size ();
+        }
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now () - start;
+      std::printf ("%8s %12.0f %14.2f %10llu\n", mode.label.c_str (), reports / elapsed.count (),
+                   elapsed.count () * 1e6 / segments, static_cast<unsigned long long> (segments));
+    }
+  return 0;
+}
@@ -0,0 +1,103 @@
+/* slru-bench.cc -------------------------------------------------------------
+ * Microbenchmark for SlruCache (NFD/daemon/fw/slru.hpp): hit latency and
+ * miss-insert-evict latency as the capacity grows from 50 to 1M entries.
+ *
+ * Every capacity is filled to the brim, then timed on
+ *   hit   – fetch() of a uniformly random resident digest (promotes or
+ *           refreshes it, so both segments keep moving);
+ *   hot   – the same over a fixed set of --hot resident digests, which
+ *           keeps the touched nodes in the CPU caches at every capacity;
+ *   evict – insert() of a new digest into the full cache.
+ * All entries share one Data packet, so the numbers are the cache's own
+ * bookkeeping, not Data allocation.  With O(1) segment tracking "hot" stays
+ * flat at every capacity; "hit" rises only once the slab and index outgrow
+ * the CPU caches and each random lookup pays DRAM latency.
+ *
+ * usage:  ./waf --run "slru-bench --ops=2000000"
+ * ------------------------------------------------------------------------- */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM/NFD/daemon/fw/slru.hpp"
+
+using namespace ns3;
+
+/* --------------------------------------------------------------------- */
+static NameDigest
+Key (uint64_t i)
+{
+  // splitmix64 finaliser: distinct, well-spread digests for 0, 1, 2, ...
+  i += 0x9e3779b97f4a7c15ull;
+  i = (i ^ (i >> 30)) * 0xbf58476d1ce4e5b9ull;
+  i = (i ^ (i >> 27)) * 0x94d049bb133111ebull;
+  return i ^ (i >> 31);
+}
+
+/* --------------------------------------------------------------------- */
+int
+main (int argc, char* argv[])
+{
+  uint32_t ops = 2000000;
+  uint32_t hot = 1024;
+
+  CommandLine cmd;
+  cmd.AddValue ("ops", "timed operations per capacity", ops);
+  cmd.AddValue ("hot", "digests in the hot set (at most the capacity)", hot);
+  cmd.Parse (argc, argv);
+
+  const auto data = std::make_shared<const ndn::Data> (ndn::Name ("/bench"));
+  std::mt19937_64 rng (1);
+
+  std::printf ("%10s %12s %12s %14s\n", "capacity", "hit ns/op", "hot ns/op", "evict ns/op");
+  for (uint64_t capacity : {50, 500, 5000, 50000, 500000, 1000000})
+    {
+      SlruCache cache (capacity / 2, capacity - capacity / 2);
+      for (uint64_t i = 0; i < capacity; ++i)
+        cache.insert (Key (i), data);
+
+      // resident after the fill: keys [0, capacity); indices drawn up front
+      std::vector<NameDigest> picks (ops);
+      for (auto& p : picks)
+        p = Key (rng () % capacity);
+
+      std::vector<NameDigest> hotSet (std::min<uint64_t> (hot, capacity));
+      for (auto& h : hotSet)
+        h = Key (rng () % capacity);
+      std::vector<NameDigest> hotPicks (ops);
+      for (auto& p : hotPicks)
+        p = hotSet[rng () % hotSet.size ()];
+
+      uint64_t misses = 0;
+      auto start = std::chrono::steady_clock::now ();
+      for (NameDigest d : picks)
+        misses += cache.fetch (d) == nullptr;
+      const std::chrono::duration<double, std::nano> hit = std::chrono::steady_clock::now () - start;
+
+      start = std::chrono::steady_clock::now ();
+      for (NameDigest d : hotPicks)
+        misses += cache.fetch (d) == nullptr;
+      const std::chrono::duration<double, std::nano> hotHit = std::chrono::steady_clock::now () - start;
+
+      start = std::chrono::steady_clock::now ();
+      for (uint64_t i = 0; i < ops; ++i)
+        cache.insert (Key (capacity + i), data);
+      const std::chrono::duration<double, std::nano> evict = std::chrono::steady_clock::now () - start;
+
+      if (misses != 0)
+        {
+          std::fprintf (stderr, "capacity %llu: %llu unexpected misses\n",
+                        static_cast<unsigned long long> (capacity),
+                        static_cast<unsigned long long> (misses));
+          return 1;
+        }
+      std::printf ("%10llu %12.1f %12.1f %14.1f\n", static_cast<unsigned long long> (capacity),
+                   hit.count () / ops, hotHit.count () / ops, evict.count () / ops);
+    }
+  return 0;
+}
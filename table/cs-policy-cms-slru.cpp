@@ -0,0 +1,124 @@
+// cs-policy-cms-slru.cpp — CMS-gated Segmented LRU Content Store policy
+
+#include "cs-policy-cms-slru.hpp"
+#include "table/cs.hpp"
+
+namespace nfd {
+namespace cs {
+namespace cms_slru {
+
+const std::string CmsSlruPolicy::POLICY_NAME = "cms_slru";
+NFD_REGISTER_CS_POLICY(CmsSlruPolicy);
+
+CmsSlruPolicy::CmsSlruPolicy()
+  : Policy(POLICY_NAME)
+  , m_sketch(SKETCH_DEPTH, SKETCH_WIDTH)
+{
+}
+
+// ────────────────────────────────────────────────────────────────
+// Policy hooks
+void
+CmsSlruPolicy::doAfterInsert(EntryRef i)
+{
+  BOOST_ASSERT(this->getCs() != nullptr);
+  syncLimit();
+  const uint64_t estNew = touch(i);
+
+  // full: the newcomer must at least tie the entry it would displace, else it
+  // leaves again before ever being queued
+  if (this->getCs()->size() > this->getLimit() &&
+      ((m_probation.empty() && m_protected.empty()) ||
+       m_sketch.estimate(computeNameDigest(victim()->getName())) > estNew)) {
+    this->emitSignal(beforeEvict, i);
+    return;
+  }
+
+  m_probation.push_back(i);
+  this->evictEntries();
+}
+
+void
+CmsSlruPolicy::doAfterRefresh(EntryRef i)
+{
+  touch(i);
+  promote(i);
+}
+
+void
+CmsSlruPolicy::doBeforeErase(EntryRef i)
+{
+  m_probation.get<1>().erase(i);
+  m_protected.get<1>().erase(i);
+}
+
+void
+CmsSlruPolicy::doBeforeUse(EntryRef i)
+{
+  touch(i);
+  promote(i);
+}
+
+void
+CmsSlruPolicy::evictEntries()
+{
+  BOOST_ASSERT(this->getCs() != nullptr);
+  syncLimit();
+  while (this->getCs()->size() > this->getLimit()) {
+    BOOST_ASSERT(!m_probation.empty() || !m_protected.empty());
+    Queue& queue = m_probation.empty() ? m_protected : m_probation;
+    EntryRef i = queue.front();
+    queue.pop_front();
+    this->emitSignal(beforeEvict, i);
+  }
+}
+
+// ────────────────────────────────────────────────────────────────
+// segments & sketch
+uint64_t
+CmsSlruPolicy::touch(EntryRef i)
+{
+  const NameDigest digest = computeNameDigest(i->getName());
+  m_sketch.increment(digest);
+  return m_sketch.estimate(digest);
+}
+
+void
+CmsSlruPolicy::promote(EntryRef i)
+{
+  auto& protIndex = m_protected.get<1>();
+  auto it = protIndex.find(i);
+  if (it != protIndex.end()) {
+    m_protected.relocate(m_protected.end(), m_protected.project<0>(it));
+    return;
+  }
+
+  if (m_probation.get<1>().erase(i) == 0)
+    return;                                       // rejected on insert, not queued
+  m_protected.push_back(i);
+
+  const size_t protLimit = this->getLimit() * PROTECTED_PERCENT / 100;
+  while (m_protected.size() > protLimit && !m_protected.empty()) {
+    m_probation.push_back(m_protected.front());
+    m_protected.pop_front();
+  }
+}
+
+Policy::EntryRef
+CmsSlruPolicy::victim() const
+{
+  return m_probation.empty() ? m_protected.front() : m_probation.front();
+}
+
+void
+CmsSlruPolicy::syncLimit()
+{
+  if (m_sketchLimit == this->getLimit())
+    return;
+  m_sketchLimit = this->getLimit();
+  m_sketch.setHalvingPeriod(HALVING_FACTOR * m_sketchLimit);
+}
+
+} // namespace cms_slru
+} // namespace cs
+} // namespace nfd
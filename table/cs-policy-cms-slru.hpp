@@ -0,0 +1,112 @@
+// cs-policy-cms-slru.hpp
+// ===========================
+#ifndef NFD_DAEMON_TABLE_CS_POLICY_CMS_SLRU_HPP
+#define NFD_DAEMON_TABLE_CS_POLICY_CMS_SLRU_HPP
+
+#include "table/cs-policy.hpp"
+#include "fw/cms.hpp"
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/identity.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+
+namespace nfd {
+namespace cs {
+namespace cms_slru {
+
+struct EntryItHasher
+{
+  size_t
+  operator()(const Policy::EntryRef& it) const
+  {
+    return std::hash<const Entry*>()(&*it);
+  }
+};
+
+/// LRU order (front = least recent) with O(1) lookup by entry
+using Queue = boost::multi_index_container<
+    Policy::EntryRef,
+    boost::multi_index::indexed_by<
+      boost::multi_index::sequenced<>,
+      boost::multi_index::hashed_unique<
+        boost::multi_index::identity<Policy::EntryRef>, EntryItHasher
+      >
+    >
+  >;
+
+/** \brief Segmented LRU with a Count-Min Sketch admission gate.
+ *
+ *  The CS-resident counterpart of the strategy's SlruCache: new Data enters
+ *  the probation segment, a hit promotes it to the protected one (whose
+ *  overflow is demoted back to probation), and eviction takes the LRU end of
+ *  probation first.  When the CS is full, a newly inserted entry is kept only
+ *  if its sketch estimate is not below the victim's; otherwise it is evicted
+ *  at once.
+ *
+ *  The sketch counts insertions and CS hits, and is halved every
+ *  HALVING_FACTOR × limit increments so old popularity fades.
+ *
+ *  Select with StackHelper::setPolicy("nfd::cs::cms_slru").
+ */
+class CmsSlruPolicy final : public Policy
+{
+public:
+  CmsSlruPolicy();
+
+public:
+  static const std::string POLICY_NAME;
+
+  static constexpr size_t   SKETCH_DEPTH      = 4;
+  static constexpr size_t   SKETCH_WIDTH      = 2048;
+  static constexpr uint64_t HALVING_FACTOR    = 10;
+  static constexpr size_t   PROTECTED_PERCENT = 50;   ///< share of the limit
+
+private:
+  void
+  doAfterInsert(EntryRef i) final;
+
+  void
+  doAfterRefresh(EntryRef i) final;
+
+  void
+  doBeforeErase(EntryRef i) final;
+
+  void
+  doBeforeUse(EntryRef i) final;
+
+  void
+  evictEntries() final;
+
+private:
+  /// count one access to @p i in the sketch, returning its new estimate
+  uint64_t
+  touch(EntryRef i);
+
+  /// move @p i to the MRU end of protected, demoting protected overflow
+  void
+  promote(EntryRef i);
+
+  /// LRU entry of probation, else of protected; queues must not both be empty
+  EntryRef
+  victim() const;
+
+  /// re-derive the halving period after the CS limit changed
+  void
+  syncLimit();
+
+private:
+  CountMinSketch m_sketch;
+  size_t         m_sketchLimit = 0;   ///< limit the halving period was sized for
+  Queue          m_probation;
+  Queue          m_protected;
+};
+
+} // namespace cms_slru
+
+using cms_slru::CmsSlruPolicy;
+
+} // namespace cs
+} // namespace nfd
+
+#endif // NFD_DAEMON_TABLE_CS_POLICY_CMS_SLRU_HPP